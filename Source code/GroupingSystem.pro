@@ -20,6 +20,17 @@ macx {
     QMAKE_MACOSX_DEPLOYMENT_TARGET = 10.14
 }
 
+# 可选：启用 AVX2 指令加速位集合运算（qmake CONFIG+=avx2）
+avx2 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+    else: QMAKE_CXXFLAGS += -mavx2
+}
+
+# 可选：统计求解各阶段的堆分配和容器复制，结果写入日志（qmake CONFIG+=allocstats，仅用于调试）
+allocstats {
+    DEFINES += GROUPING_ALLOC_STATS
+}
+
 # 添加资源文件（用于运行时）
 RESOURCES += resources.qrc
 
@@ -29,11 +40,53 @@ SOURCES += \
     mainwindow_ui.cpp \
     mainwindow_core.cpp \
     mainwindow_algorithm.cpp \
-    mainwindow_updates.cpp
+    mainwindow_updates.cpp \
+    mainwindow_exam.cpp \
+    mainwindow_rotation.cpp \
+    mainwindow_history.cpp \
+    mainwindow_incremental.cpp \
+    mainwindow_reseat.cpp \
+    mainwindow_explain.cpp \
+    mainwindow_lns.cpp \
+    mainwindow_manualmove.cpp \
+    seatinghistory.cpp \
+    assignmentscore.cpp \
+    problemmodel.cpp \
+    exactsolver.cpp \
+    personbitset.cpp \
+    lnsengine.cpp \
+    cyclicexchange.cpp \
+    portfolio.cpp \
+    solutionsnapshot.cpp \
+    taskpool.cpp \
+    allocstats.cpp \
+    grouptablemodel.cpp \
+    seatmapwidget.cpp \
+    swapadvisor.cpp \
+    edithistory.cpp
 
 # 头文件
 HEADERS += \
-    mainwindow.h
+    mainwindow.h \
+    seatinghistory.h \
+    assignmentscore.h \
+    problemmodel.h \
+    exactsolver.h \
+    personbitset.h \
+    groupkernels.h \
+    lnsengine.h \
+    cyclicexchange.h \
+    canceltoken.h \
+    portfolio.h \
+    solutionsnapshot.h \
+    taskpool.h \
+    counterrng.h \
+    solverarena.h \
+    allocstats.h \
+    grouptablemodel.h \
+    seatmapwidget.h \
+    swapadvisor.h \
+    edithistory.h
 
 # 启用调试信息
 CONFIG += debug
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "allocstats.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+
+#ifdef GROUPING_ALLOC_STATS
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<quint64> allocationCount{ 0 };
+std::atomic<quint64> allocatedBytes{ 0 };
+
+} // namespace
+
+// 全局分配函数的替换：计数后转给 malloc/free
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
+
+namespace {
+
+struct SiteCounts {
+    quint64 copies = 0;
+    quint64 detaches = 0;
+};
+
+std::atomic<quint64> copyCount{ 0 };
+std::atomic<quint64> detachCount{ 0 };
+std::atomic<quint64> containerBytes{ 0 };
+
+// 以字面量地址为键，只在某个热点第一次出现时分配一个节点
+std::mutex siteMutex;
+std::map<const char*, SiteCounts> sites;
+
+} // namespace
+
+namespace AllocStats {
+
+Counters current()
+{
+    Counters counters;
+#ifdef GROUPING_ALLOC_STATS
+    counters.allocations = allocationCount.load(std::memory_order_relaxed);
+    counters.bytes = allocatedBytes.load(std::memory_order_relaxed);
+#endif
+    counters.copies = copyCount.load(std::memory_order_relaxed);
+    counters.detaches = detachCount.load(std::memory_order_relaxed);
+    counters.containerBytes = containerBytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void noteCopy(const char* site, quint64 bytes)
+{
+    copyCount.fetch_add(1, std::memory_order_relaxed);
+    containerBytes.fetch_add(bytes, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(siteMutex);
+    sites[site].copies++;
+}
+
+void noteDetach(const char* site, quint64 bytes)
+{
+    detachCount.fetch_add(1, std::memory_order_relaxed);
+    containerBytes.fetch_add(bytes, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(siteMutex);
+    sites[site].detaches++;
+}
+
+QStringList siteReport()
+{
+    std::lock_guard<std::mutex> lock(siteMutex);
+    QStringList lines;
+    for (const auto& entry : sites) {
+        lines.append(QString("  热点 %1: 复制 %2 次, 分离 %3 次")
+            .arg(QString::fromUtf8(entry.first)).arg(entry.second.copies).arg(entry.second.detaches));
+    }
+    return lines;
+}
+
+} // namespace AllocStats
+
+void PhaseProfiler::begin(const QString& name)
+{
+    end();
+    currentName = name;
+    start = AllocStats::current();
+    running = true;
+    timer.start();
+}
+
+void PhaseProfiler::end()
+{
+    if (!running) return;
+    qint64 nsecs = timer.nsecsElapsed();
+    AllocStats::Counters now = AllocStats::current();
+    AllocStats::Counters delta;
+    delta.allocations = now.allocations - start.allocations;
+    delta.bytes = now.bytes - start.bytes;
+    delta.copies = now.copies - start.copies;
+    delta.detaches = now.detaches - start.detaches;
+    delta.containerBytes = now.containerBytes - start.containerBytes;
+    phases.append({ currentName, nsecs, delta });
+    running = false;
+}
+
+QString PhaseProfiler::summary() const
+{
+    QStringList parts;
+    qint64 total = 0;
+    for (const Phase& phase : phases) {
+        parts.append(QString("%1 %2 μs").arg(phase.name).arg(phase.nsecs / 1000));
+        total += phase.nsecs;
+    }
+    return QString("%1 (合计 %2 μs)").arg(parts.join(" | ")).arg(total / 1000);
+}
+
+QStringList PhaseProfiler::details() const
+{
+    QStringList lines;
+    if (!AllocStats::enabled) return lines;
+    for (const Phase& phase : phases) {
+        lines.append(QString("  %1: 分配 %2 次 / %3 KB, 复制 %4 次, 分离 %5 次, 容器存储 %6 KB")
+            .arg(phase.name).arg(phase.counters.allocations)
+            .arg(phase.counters.bytes / 1024.0, 0, 'f', 1)
+            .arg(phase.counters.copies).arg(phase.counters.detaches)
+            .arg(phase.counters.containerBytes / 1024.0, 0, 'f', 1));
+    }
+    return lines;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+// 调试用的堆分配与容器复制统计，qmake CONFIG+=allocstats 时启用（定义 GROUPING_ALLOC_STATS）。
+// 启用后替换全局 operator new/delete 以统计分配次数和字节数，QMap 的节点经 std::map 分配，已计入其中；
+// QVector 的存储由 Qt 直接 malloc，不经过 operator new，
+// 因此在热点处用 ALLOC_STATS_COPY 记录深复制、用 ALLOC_STATS_DETACH 在写入前检查并记录
+// 隐式共享的分离，两者都按容器存储大小另计字节数。
+// 未启用时这些宏为空操作，PhaseProfiler 只记录各阶段用时
+namespace AllocStats {
+
+struct Counters {
+    quint64 allocations = 0;
+    quint64 bytes = 0;          // 经 operator new 分配的字节数
+    quint64 copies = 0;
+    quint64 detaches = 0;
+    quint64 containerBytes = 0; // 热点处复制、分离的 QVector 存储字节数
+};
+
+#ifdef GROUPING_ALLOC_STATS
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+// 进程启动以来的累计值
+Counters current();
+
+// 热点处的一次容器复制 / 隐式共享分离，site 须为字符串字面量
+void noteCopy(const char* site, quint64 bytes);
+void noteDetach(const char* site, quint64 bytes);
+
+// 复制或分离时新分配的、不经过 operator new 的存储字节数
+template <typename T>
+quint64 storageBytes(const QVector<T>& container) { return quint64(container.size()) * sizeof(T); }
+template <typename K, typename V>
+quint64 storageBytes(const QMap<K, V>&) { return 0; }
+
+// 各热点累计的复制、分离次数，每个热点一行
+QStringList siteReport();
+
+} // namespace AllocStats
+
+// ALLOC_STATS_DETACH 放在对容器的非 const 访问之前：此时仍与他人共享的非空容器会在这次访问中分离
+// （空容器没有数据块，isDetached() 也为 false，不计入）
+#ifdef GROUPING_ALLOC_STATS
+#define ALLOC_STATS_COPY(site, container) \
+    AllocStats::noteCopy(site, AllocStats::storageBytes(container))
+#define ALLOC_STATS_DETACH(site, container) \
+    do { if (!(container).isEmpty() && !(container).isDetached()) AllocStats::noteDetach(site, AllocStats::storageBytes(container)); } while (0)
+#else
+#define ALLOC_STATS_COPY(site, container) ((void)0)
+#define ALLOC_STATS_DETACH(site, container) ((void)0)
+#endif
+
+// 按阶段记录用时，启用统计时同时记录每个阶段的分配、复制和分离次数
+class PhaseProfiler {
+public:
+    // 结束上一个阶段（如果有）并开始新阶段
+    void begin(const QString& name);
+    void end();
+
+    // 一行汇总各阶段用时
+    QString summary() const;
+    // 启用统计时每个阶段一行分配明细，未启用时为空
+    QStringList details() const;
+
+private:
+    struct Phase {
+        QString name;
+        qint64 nsecs;
+        AllocStats::Counters counters;
+    };
+    QVector<Phase> phases;
+    QString currentName;
+    QElapsedTimer timer;
+    AllocStats::Counters start;
+    bool running = false;
+};
+
+#endif // ALLOCSTATS_H
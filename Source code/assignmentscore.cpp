@@ -0,0 +1,180 @@
+#include "assignmentscore.h"
+#include <QtGlobal>
+#include <cstdlib>
+
+void AssignmentScore::build(std::shared_ptr<const ProblemModel> problem, const QVector<QVector<int>>& groups)
+{
+    model = std::move(problem);
+    int groupCount = model->groupCount;
+
+    personGroup = QVector<int>(model->personCount + 1, -1);
+    males = QVector<int>(groupCount, 0);
+    females = QVector<int>(groupCount, 0);
+    leaderCount = QVector<int>(groupCount, 0);
+    boarderCount = QVector<int>(groupCount, 0);
+    togetherCount = QVector<QVector<int>>(model->togetherCount(), QVector<int>(groupCount, 0));
+    separateCount = QVector<QVector<int>>(model->separateCount(), QVector<int>(groupCount, 0));
+    togetherGroups = QVector<int>(model->togetherCount(), 0);
+    boarderCap = groupCount > 0 ? (model->boarderTotal + groupCount - 1) / groupCount : 0;
+
+    // 空分组的基础代价（例如没有组长的组）
+    totalPenalty = 0;
+    for (int g = 0; g < groupCount; g++) {
+        totalPenalty += groupPenalty(g);
+    }
+
+    for (int g = 0; g < groups.size() && g < groupCount; g++) {
+        for (int person : groups[g]) {
+            if (person >= 1 && person <= model->personCount) {
+                applyMove(person, g);
+            }
+        }
+    }
+}
+
+int AssignmentScore::groupPenalty(int g) const
+{
+    int penalty = 0;
+
+    if (model->quotaMales[g] >= 0) {
+        penalty += std::abs(males[g] - model->quotaMales[g]) * ScoreWeights::QUOTA;
+    }
+    if (model->quotaFemales[g] >= 0) {
+        penalty += std::abs(females[g] - model->quotaFemales[g]) * ScoreWeights::QUOTA;
+    }
+
+    // 组长足够时每组恰好一个，不够时只要求不重复
+    if (model->leaderTotal >= model->groupCount) {
+        penalty += std::abs(leaderCount[g] - 1) * ScoreWeights::LEADER;
+    }
+    else if (leaderCount[g] > 1) {
+        penalty += (leaderCount[g] - 1) * ScoreWeights::LEADER;
+    }
+
+    if (boarderCount[g] > boarderCap) {
+        penalty += (boarderCount[g] - boarderCap) * ScoreWeights::BOARDER;
+    }
+
+    return penalty;
+}
+
+void AssignmentScore::removeFromGroup(int person, int g)
+{
+    totalPenalty -= groupPenalty(g);
+    if (model->isMale(person)) males[g]--; else females[g]--;
+    if (model->isLeader(person)) leaderCount[g]--;
+    if (model->isBoarder(person)) boarderCount[g]--;
+    totalPenalty += groupPenalty(g);
+
+    for (int s : model->separateSetsOf(person)) {
+        int& count = separateCount[s][g];
+        if (count >= 2) totalPenalty -= ScoreWeights::SEPARATE;
+        count--;
+    }
+
+    for (int s : model->togetherSetsOf(person)) {
+        int& count = togetherCount[s][g];
+        count--;
+        if (count == 0) {
+            if (togetherGroups[s] >= 2) totalPenalty -= ScoreWeights::TOGETHER;
+            togetherGroups[s]--;
+        }
+    }
+}
+
+void AssignmentScore::addToGroup(int person, int g)
+{
+    totalPenalty -= groupPenalty(g);
+    if (model->isMale(person)) males[g]++; else females[g]++;
+    if (model->isLeader(person)) leaderCount[g]++;
+    if (model->isBoarder(person)) boarderCount[g]++;
+    totalPenalty += groupPenalty(g);
+
+    for (int s : model->separateSetsOf(person)) {
+        int& count = separateCount[s][g];
+        if (count >= 1) totalPenalty += ScoreWeights::SEPARATE;
+        count++;
+    }
+
+    for (int s : model->togetherSetsOf(person)) {
+        int& count = togetherCount[s][g];
+        if (count == 0) {
+            if (togetherGroups[s] >= 1) totalPenalty += ScoreWeights::TOGETHER;
+            togetherGroups[s]++;
+        }
+        count++;
+    }
+}
+
+void AssignmentScore::applyMove(int person, int toGroup)
+{
+    int fromGroup = personGroup[person];
+    if (fromGroup == toGroup) return;
+
+    if (fromGroup >= 0) removeFromGroup(person, fromGroup);
+    if (toGroup >= 0) addToGroup(person, toGroup);
+    personGroup[person] = toGroup;
+}
+
+void AssignmentScore::applySwap(int a, int b)
+{
+    int ga = personGroup[a];
+    int gb = personGroup[b];
+    applyMove(a, gb);
+    applyMove(b, ga);
+}
+
+int AssignmentScore::moveDelta(int person, int toGroup)
+{
+    int fromGroup = personGroup[person];
+    int before = totalPenalty;
+    applyMove(person, toGroup);
+    int delta = totalPenalty - before;
+    applyMove(person, fromGroup);
+    return delta;
+}
+
+int AssignmentScore::swapDelta(int a, int b)
+{
+    int before = totalPenalty;
+    applySwap(a, b);
+    int delta = totalPenalty - before;
+    applySwap(a, b);
+    return delta;
+}
+
+int AssignmentScore::groupExchangeDelta(int g, int out, int in)
+{
+    int before = totalPenalty;
+    if (out != 0) removeFromGroup(out, g);
+    if (in != 0) addToGroup(in, g);
+    int delta = totalPenalty - before;
+    if (in != 0) removeFromGroup(in, g);
+    if (out != 0) addToGroup(out, g);
+    return delta;
+}
+
+QVector<int> AssignmentScore::violatedGroups() const
+{
+    QVector<bool> violated(model->groupCount, false);
+    for (int g = 0; g < model->groupCount; g++) {
+        if (groupPenalty(g) > 0) violated[g] = true;
+    }
+    for (const auto& counts : separateCount) {
+        for (int g = 0; g < model->groupCount; g++) {
+            if (counts[g] > 1) violated[g] = true;
+        }
+    }
+    for (int s = 0; s < togetherCount.size(); s++) {
+        if (togetherGroups[s] <= 1) continue;
+        for (int g = 0; g < model->groupCount; g++) {
+            if (togetherCount[s][g] > 0) violated[g] = true;
+        }
+    }
+
+    QVector<int> result;
+    for (int g = 0; g < model->groupCount; g++) {
+        if (violated[g]) result.append(g);
+    }
+    return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef ASSIGNMENTSCORE_H
+#define ASSIGNMENTSCORE_H
+
+#include <QVector>
+#include "problemmodel.h"
+
+// 各类违反项的权重
+struct ScoreWeights {
+    static const int TOGETHER = 10;
+    static const int SEPARATE = 10;
+    static const int LEADER = 5;
+    static const int QUOTA = 3;
+    static const int BOARDER = 1;
+};
+
+// 增量评分：维护每组的性别、组长、外宿生计数和每个要求在各组的人数，
+// 单人移动或交换只重算涉及的两个组和该人员所属的要求，代价与组数、人数无关
+class AssignmentScore {
+public:
+    void build(std::shared_ptr<const ProblemModel> problem, const QVector<QVector<int>>& groups);
+
+    int total() const { return totalPenalty; }
+    int groupOf(int person) const { return personGroup[person]; }
+
+    // 人员移动到另一组（toGroup 为 -1 表示移出）
+    void applyMove(int person, int toGroup);
+    void applySwap(int a, int b);
+
+    // 试探性计算移动/交换带来的代价变化，计算后恢复原状态
+    int moveDelta(int person, int toGroup);
+    int swapDelta(int a, int b);
+
+    // 只看组 g 的代价变化：out 离开、in 进入（0 表示没有），不考虑 in 原来所在的组。
+    // 结果只在 out、in 都不属于任何必须同组要求时精确（同组要求的代价跨组计算）
+    int groupExchangeDelta(int g, int out, int in);
+
+    // 当前代价大于零的组
+    QVector<int> violatedGroups() const;
+
+    // 单个要求的当前状态：必须同组要求是否满足，必须分开要求在组 g 中的人数
+    bool togetherSatisfied(int s) const { return togetherGroups[s] <= 1; }
+    int separateCountIn(int s, int g) const { return separateCount[s][g]; }
+
+private:
+    int groupPenalty(int g) const;
+    void removeFromGroup(int person, int g);
+    void addToGroup(int person, int g);
+
+    std::shared_ptr<const ProblemModel> model;
+    QVector<int> personGroup;
+    QVector<int> males;
+    QVector<int> females;
+    QVector<int> leaderCount;
+    QVector<int> boarderCount;
+    QVector<QVector<int>> togetherCount; // 要求下标 -> 组 -> 人数
+    QVector<QVector<int>> separateCount;
+    QVector<int> togetherGroups;         // 要求下标 -> 分布的组数
+    int boarderCap = 0;
+    int totalPenalty = 0;
+};
+
+#endif // ASSIGNMENTSCORE_H
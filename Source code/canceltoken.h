@@ -0,0 +1,25 @@
+#pragma once
+
+#ifndef CANCELTOKEN_H
+#define CANCELTOKEN_H
+
+#include <atomic>
+
+// 协作式取消标记：由发起方置位，求解循环定期检查后自行退出。
+// 有上级标记时，上级被置位也视为已取消
+class CancelToken {
+public:
+    CancelToken() = default;
+    explicit CancelToken(const CancelToken* parentToken) : parent(parentToken) {}
+
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const {
+        return cancelled.load(std::memory_order_relaxed) || (parent && parent->isCancelled());
+    }
+
+private:
+    std::atomic<bool> cancelled{ false };
+    const CancelToken* parent = nullptr;
+};
+
+#endif // CANCELTOKEN_H
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef COUNTERRNG_H
+#define COUNTERRNG_H
+
+#include <QtGlobal>
+
+// 随机数流的用途，与种子、流编号一起决定一个独立的流
+enum class RngPhase : quint64 {
+    Construct = 1,      // 贪心构造分组
+    SameGenderPick,     // 组内随机挑选同性别人员
+    Portfolio,          // 求解组合中的各策略
+    Rotation,           // 轮换计划各周的优化
+    RotationMerge       // 轮换计划的合并顺序
+};
+
+// SplitMix64 的混合函数
+inline quint64 splitMix64(quint64 x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// 计数器式随机数发生器
+// (种子, 流编号, 用途) 经混合得到流的密钥，第 n 个随机数只取决于密钥和 n，
+// 不依赖任何共享状态。多线程或多起点运行时每个任务使用自己的流，
+// 结果与线程调度无关，也可以在单线程中按相同参数逐一重放。
+// 满足 UniformRandomBitGenerator，可直接用于 std::shuffle 和各种分布
+class CounterRng {
+public:
+    using result_type = quint64;
+
+    explicit CounterRng(quint64 seed, quint64 stream = 0, RngPhase phase = RngPhase::Construct)
+        : key(streamKey(seed, stream, phase)) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() { return splitMix64(key + counter++ * 0xD1B54A32D192ED03ULL); }
+
+    // 已取出的随机数个数，可用于跳到流中的任意位置
+    quint64 position() const { return counter; }
+    void seek(quint64 position) { counter = position; }
+
+    // 派生子任务的种子（供接受整数种子的求解器使用）
+    static quint64 streamKey(quint64 seed, quint64 stream, RngPhase phase)
+    {
+        return splitMix64(splitMix64(splitMix64(seed) ^ stream) ^ quint64(phase));
+    }
+
+private:
+    quint64 key;
+    quint64 counter = 0;
+};
+
+#endif // COUNTERRNG_H
@@ -0,0 +1,207 @@
+#include "cyclicexchange.h"
+#include <QElapsedTimer>
+#include <algorithm>
+
+CyclicExchange::CyclicExchange(std::shared_ptr<const ProblemModel> problem, quint64 seed)
+    : model(std::move(problem)), rng(seed),
+    nodes(arena.resource()), arcBegin(arena.resource()), arcList(arena.resource()), order(arena.resource()),
+    groupUsed(arena.resource()), cycle(arena.resource()), changes(arena.resource()), appended(arena.resource()),
+    vacated(arena.resource())
+{
+}
+
+CyclicExchangeResult CyclicExchange::run(const QVector<QVector<int>>& groups, qint64 timeBudgetMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    CyclicExchangeResult result;
+    current = groups;
+    score.build(model, current);
+    result.initialPenalty = score.total();
+
+    if (model->groupCount >= 2 && current.size() == model->groupCount) {
+        while (score.total() > 0) {
+            if (timer.elapsed() >= timeBudgetMs || (cancelToken && cancelToken->isCancelled())) {
+                result.interrupted = true;
+                break;
+            }
+            buildGraph();
+            if (!findNegativeCycle()) break;
+
+            int before = score.total();
+            applyCycle();
+            if (score.total() >= before) {
+                // 边权与实际不符时退回并停止，避免来回循环
+                undoCycle();
+                break;
+            }
+
+            result.cycles++;
+            if (snapshot) snapshot->offer(current, score.total());
+            for (int v : cycle) {
+                if (nodes[v].person == 0) {
+                    result.chains++;
+                    break;
+                }
+            }
+        }
+    }
+
+    result.groups = current;
+    result.finalPenalty = score.total();
+    return result;
+}
+
+void CyclicExchange::buildGraph()
+{
+    nodes.clear();
+    for (int g = 0; g < current.size(); g++) {
+        bool hasEmptySeat = false;
+        for (int s = 0; s < current[g].size(); s++) {
+            int person = current[g][s];
+            if (person == 0) {
+                hasEmptySeat = true;
+                continue;
+            }
+            if (model->isFixed(person) || !model->togetherSetsOf(person).isEmpty()) continue;
+            nodes.push_back({ person, g, s });
+        }
+        // 生成分组时去掉了座位中的 0，未坐满的容量同样作为空位
+        if (hasEmptySeat || current[g].size() < model->capacity[g]) {
+            nodes.push_back({ 0, g, -1 });
+        }
+    }
+
+    int nodeCount = int(nodes.size());
+    arcBegin.assign(nodeCount + 1, 0);
+    arcList.clear();
+    for (int u = 0; u < nodeCount; u++) {
+        arcBegin[u] = int(arcList.size());
+        for (int w = 0; w < nodeCount; w++) {
+            const Node& from = nodes[u];
+            const Node& to = nodes[w];
+            if (from.group == to.group) continue;
+            if (from.person == 0 && to.person == 0) continue;
+            if (from.person != 0 && to.person != 0 && model->isMale(from.person) != model->isMale(to.person)) continue;
+            arcList.push_back({ w, score.groupExchangeDelta(to.group, to.person, from.person) });
+        }
+    }
+    arcBegin[nodeCount] = int(arcList.size());
+}
+
+// 按增益准则搜索：只沿前缀和为负的路径扩展。任何负权环都存在一个起点使所有前缀和为负，
+// 因此从每个节点出发搜索即可覆盖所有长度不超过 maxCycleLength 的负权环
+bool CyclicExchange::findNegativeCycle()
+{
+    order.resize(nodes.size());
+    for (int v = 0; v < int(nodes.size()); v++) {
+        order[v] = v;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+
+    groupUsed.assign(current.size(), 0);
+    expansions = 0;
+    for (int start : order) {
+        if (nodes[start].person == 0) continue;
+        cycle.assign(1, start);
+        groupUsed[nodes[start].group] = 1;
+        bool found = extend(start, start, 0);
+        groupUsed[nodes[start].group] = 0;
+        if (found) return true;
+        if (expansions >= expansionLimit) break;
+    }
+    cycle.clear();
+    return false;
+}
+
+bool CyclicExchange::extend(int start, int node, int cost)
+{
+    for (int i = arcBegin[node]; i < arcBegin[node + 1]; i++) {
+        const Arc& arc = arcList[i];
+        int total = cost + arc.cost;
+        if (total >= 0) continue;
+        if (arc.to == start) {
+            if (cycle.size() >= 2) return true;
+            continue;
+        }
+        if (int(cycle.size()) >= maxCycleLength || groupUsed[nodes[arc.to].group]) continue;
+        if (++expansions >= expansionLimit) return false;
+
+        cycle.push_back(arc.to);
+        groupUsed[nodes[arc.to].group] = 1;
+        bool found = extend(start, arc.to, total);
+        groupUsed[nodes[arc.to].group] = 0;
+        if (found) return true;
+        cycle.pop_back();
+    }
+    return false;
+}
+
+// 环上每个人进入下一个节点所在的组：顶替下一个人的座位，或坐进该组的空位；
+// 空位节点的下一个人离开后座位留空
+void CyclicExchange::applyCycle()
+{
+    int k = int(cycle.size());
+    changes.clear();
+    appended.clear();
+    vacated.clear();
+    for (int v : cycle) {
+        const Node& node = nodes[v];
+        if (node.person == 0) continue;
+        changes.push_back({ node.group, node.seat, node.person });
+        current[node.group][node.seat] = 0;
+    }
+    for (int i = 0; i < k; i++) {
+        const Node& from = nodes[cycle[i]];
+        const Node& to = nodes[cycle[(i + 1) % k]];
+        if (from.person == 0) continue;
+
+        int seat = to.seat;
+        if (to.person == 0) {
+            seat = current[to.group].indexOf(0);
+            if (seat < 0) {
+                seat = current[to.group].size();
+                current[to.group].append(0);
+                appended.push_back(to.group);
+            }
+            changes.push_back({ to.group, seat, 0 });
+        }
+        current[to.group][seat] = from.person;
+        score.applyMove(from.person, to.group);
+    }
+
+    // 弹出链中空位后面那个人离开后没有人补进他的座位。原来没有空位的组删掉这个座位，
+    // 使生成的分组仍然没有 0；后面坐着固定位置的人时保留空位，以免他们的座位号改变
+    for (int i = 0; i < k; i++) {
+        if (nodes[cycle[i]].person != 0) continue;
+        const Node& left = nodes[cycle[(i + 1) % k]];
+        if (left.person == 0) continue;
+        QVector<int>& group = current[left.group];
+        bool removable = std::count(group.begin(), group.end(), 0) == 1;
+        for (int s = left.seat + 1; s < group.size() && removable; s++) {
+            if (model->isFixed(group[s])) removable = false;
+        }
+        if (removable) {
+            group.remove(left.seat);
+            vacated.push_back({ left.group, left.seat });
+        }
+    }
+}
+
+// 按记录把改动过的座位恢复原状
+void CyclicExchange::undoCycle()
+{
+    for (auto it = vacated.rbegin(); it != vacated.rend(); ++it) {
+        current[it->group].insert(it->seat, 0);
+    }
+    for (const SeatChange& change : changes) {
+        current[change.group][change.seat] = change.person;
+    }
+    for (const SeatChange& change : changes) {
+        if (change.person != 0) score.applyMove(change.person, change.group);
+    }
+    for (int g : appended) {
+        current[g].removeLast();
+    }
+}
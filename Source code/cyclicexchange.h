@@ -0,0 +1,90 @@
+#pragma once
+
+#ifndef CYCLICEXCHANGE_H
+#define CYCLICEXCHANGE_H
+
+#include <QVector>
+#include <memory>
+#include "problemmodel.h"
+#include "assignmentscore.h"
+#include "canceltoken.h"
+#include "solutionsnapshot.h"
+#include "counterrng.h"
+#include "solverarena.h"
+
+struct CyclicExchangeResult {
+    QVector<QVector<int>> groups;
+    int initialPenalty = 0;
+    int finalPenalty = 0;
+    int cycles = 0;   // 应用的循环交换次数
+    int chains = 0;   // 其中经过空位的弹出链次数
+    bool interrupted = false;   // 因时限或取消在找不到改进之前停止
+};
+
+// 循环交换与弹出链
+// 改进图的节点是可移动的人以及有空座的组的"空位"，空座包括座位中的 0 和未坐满的容量
+// （groupConfigs 的座位数减去当前人数）。边 u→w 表示 u 进入 w 所在的组并顶替 w，
+// 边权是这一替换让 w 所在组的代价变化。人与人之间只在同性别时连边，不经过空位的环移动后
+// 各组男女人数不变；经过空位节点的环是一条弹出链：某人坐进空位所在的组，
+// 空位后面那个人的座位空出，这两个组的人数和男女人数会变化，由评分中的配额项计入。
+// 环上每个组只出现一次时，环的总权就是这次循环移动的准确代价变化，
+// 为此必须同组要求中的人（其代价跨组计算）和固定位置的人不参与
+class CyclicExchange {
+public:
+    CyclicExchange(std::shared_ptr<const ProblemModel> model, quint64 seed);
+
+    // 反复寻找负权环并应用，直到找不到、代价为0或超时
+    CyclicExchangeResult run(const QVector<QVector<int>>& groups, qint64 timeBudgetMs);
+
+    int maxCycleLength = 4;
+    int expansionLimit = 200000;  // 每次找环时扩展路径的次数上限
+    const CancelToken* cancelToken = nullptr;
+    SolutionSnapshot* snapshot = nullptr;
+
+private:
+    struct Node {
+        int person;   // 0 表示空位节点
+        int group;
+        int seat;
+    };
+    struct Arc {
+        int to;
+        int cost;
+    };
+
+    void buildGraph();
+    bool findNegativeCycle();
+    bool extend(int start, int node, int cost);
+    void applyCycle();
+    void undoCycle();
+
+    std::shared_ptr<const ProblemModel> model;
+    CounterRng rng;
+
+    QVector<QVector<int>> current;
+    AssignmentScore score;
+
+    // 每轮重建的改进图和搜索状态，分配在本次运行的 arena 上并复用容量
+    SolverArena arena;
+    ArenaVector<Node> nodes;
+    ArenaVector<int> arcBegin;    // 节点 v 的出边为 arcList[arcBegin[v], arcBegin[v + 1])
+    ArenaVector<Arc> arcList;
+    ArenaVector<int> order;
+    ArenaVector<char> groupUsed;
+    ArenaVector<int> cycle;
+    struct Seat {
+        int group;
+        int seat;
+    };
+    struct SeatChange {
+        int group;
+        int seat;
+        int person;   // 改动前的人员
+    };
+    ArenaVector<SeatChange> changes;
+    ArenaVector<int> appended;    // 坐进未用容量时在末尾新增座位的组，撤销时删除
+    ArenaVector<Seat> vacated;    // 弹出链空出后删除的座位，撤销时插回
+    int expansions = 0;
+};
+
+#endif // CYCLICEXCHANGE_H
@@ -0,0 +1,64 @@
+#include "edithistory.h"
+
+void EditHistory::beginStep(const QString& label, const QVector<QVector<int>>& groups)
+{
+    if (!matches(groups)) clear();
+    open = true;
+    pendingLabel = label;
+    pending.clear();
+}
+
+void EditHistory::record(int groupA, int seatA, int groupB, int seatB)
+{
+    if (!open) return;
+    pending.append({ qint16(groupA), qint16(seatA), qint16(groupB), qint16(seatB) });
+}
+
+void EditHistory::endStep(const QVector<QVector<int>>& groups)
+{
+    if (!open) return;
+    open = false;
+    if (pending.isEmpty()) return;
+
+    swaps.resize(stepBegin(applied));
+    stepEnds.resize(applied);
+    labels.erase(labels.begin() + applied, labels.end());
+
+    swaps += pending;
+    stepEnds.append(swaps.size());
+    labels.append(pendingLabel);
+    applied++;
+    pending.clear();
+    tip = groups;
+}
+
+void EditHistory::clear()
+{
+    swaps.clear();
+    stepEnds.clear();
+    labels.clear();
+    applied = 0;
+    tip.clear();
+}
+
+QVector<EditHistory::SeatSwap> EditHistory::swapsTo(int target) const
+{
+    QVector<SeatSwap> result;
+    if (target < applied) {
+        for (int i = stepBegin(applied) - 1; i >= stepBegin(target); i--) {
+            result.append(swaps[i]);
+        }
+    }
+    else {
+        for (int i = stepBegin(applied); i < stepBegin(target); i++) {
+            result.append(swaps[i]);
+        }
+    }
+    return result;
+}
+
+void EditHistory::setCurrent(int target, const QVector<QVector<int>>& groups)
+{
+    applied = target;
+    tip = groups;
+}
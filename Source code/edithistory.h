@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef EDITHISTORY_H
+#define EDITHISTORY_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+// 手动调整的撤销/重做记录
+// 每次座位交换记为一条 8 字节的记录（两个座位的位置），交换是自身的逆操作，撤销只需倒序再做一遍。
+// 一次操作（如一条交换链）中的若干交换合为一步，跳到任意一步只需依次做其间的交换。
+// 另外保留最后一次记录或跳转后 groups 的浅拷贝（与 groups 共享各组数据，不额外占用内存），
+// groups 被整体替换（重新生成、读取文件等）后与之不再相同，历史随之作废
+class EditHistory {
+public:
+    struct SeatSwap {
+        qint16 groupA;
+        qint16 seatA;
+        qint16 groupB;
+        qint16 seatB;
+    };
+
+    // 开始一步；groups 已被整体替换时先清空历史
+    void beginStep(const QString& label, const QVector<QVector<int>>& groups);
+    void record(int groupA, int seatA, int groupB, int seatB);
+    // 结束当前步骤，groups 为这一步之后的分组。没有任何交换时丢弃；否则丢弃可重做的部分
+    void endStep(const QVector<QVector<int>>& groups);
+    bool recording() const { return open; }
+
+    // groups 是否仍是最后一次记录或跳转后的状态
+    bool matches(const QVector<QVector<int>>& groups) const { return groups == tip; }
+    void clear();
+
+    int stepCount() const { return labels.size(); }
+    int currentStep() const { return applied; }   // 已应用的步数，0 为第一次调整之前
+    QString stepLabel(int step) const { return labels.value(step); }
+
+    // 从当前状态到已应用 target 步时需要依次做的交换；调用方做完后调用 setCurrent
+    QVector<SeatSwap> swapsTo(int target) const;
+    void setCurrent(int target, const QVector<QVector<int>>& groups);
+
+private:
+    int stepBegin(int step) const { return step == 0 ? 0 : stepEnds[step - 1]; }
+
+    QVector<SeatSwap> swaps;
+    QVector<int> stepEnds;        // 第 i 步的交换为 swaps[stepBegin(i), stepEnds[i])
+    QStringList labels;
+    int applied = 0;
+
+    bool open = false;
+    QString pendingLabel;
+    QVector<SeatSwap> pending;
+    QVector<QVector<int>> tip;
+};
+
+#endif // EDITHISTORY_H
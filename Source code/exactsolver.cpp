@@ -0,0 +1,135 @@
+#include "exactsolver.h"
+#include <algorithm>
+
+ExactSolver::ExactSolver(const ProblemModel& problem)
+    : model(problem)
+{
+    // 编译时已发现的矛盾（固定位置冲突、同组又不能同组等）直接判为无解
+    if (model.hasFatalConflict()) {
+        trivialInfeasible = true;
+        return;
+    }
+
+    QVector<int> unitOf(model.personCount + 1, -1);
+    for (int c = 0; c < model.clusterCount(); c++) {
+        Unit unit;
+        for (int person : model.cluster(c)) {
+            unit.members.append(person);
+            unitOf[person] = units.size();
+        }
+        unit.pinned = model.clusterGroup(c);
+        units.append(unit);
+    }
+
+    auto ensureUnit = [&](int person) {
+        if (unitOf[person] == -1) {
+            Unit unit;
+            unit.members.append(person);
+            unit.pinned = model.isFixed(person) ? model.fixedGroup(person) : -1;
+            unitOf[person] = units.size();
+            units.append(unit);
+        }
+        return unitOf[person];
+        };
+
+    for (int id = 1; id <= model.personCount; id++) {
+        if (model.isFixed(id) || !model.separateSetsOf(id).isEmpty()) ensureUnit(id);
+    }
+
+    // 不能同组要求转换为单元之间的冲突
+    for (int s = 0; s < model.separateCount(); s++) {
+        IdRange set = model.separateSet(s);
+        for (int i = 0; i < set.size(); i++) {
+            for (int j = i + 1; j < set.size(); j++) {
+                int a = unitOf[set[i]];
+                int b = unitOf[set[j]];
+                if (a == b) {
+                    if (set[i] != set[j]) trivialInfeasible = true;
+                    continue;
+                }
+                units[a].conflicts.append(b);
+                units[b].conflicts.append(a);
+            }
+        }
+    }
+
+    // 固定的单元先放，其余按冲突数和人数从多到少
+    for (int u = 0; u < units.size(); u++) {
+        order.append(u);
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        bool pa = units[a].pinned >= 0;
+        bool pb = units[b].pinned >= 0;
+        if (pa != pb) return pa;
+        int wa = units[a].conflicts.size() + units[a].members.size();
+        int wb = units[b].conflicts.size() + units[b].members.size();
+        return wa > wb;
+        });
+}
+
+ExactSolver::Result ExactSolver::solve(int limit, QVector<int>* personGroups)
+{
+    if (trivialInfeasible) return Infeasible;
+
+    nodeCount = 0;
+    nodeLimit = limit;
+    unitGroup = QVector<int>(units.size(), -1);
+    freeSeats = model.capacity;
+
+    bool found = search(0);
+    if (!found) {
+        return nodeCount >= nodeLimit ? Unknown : Infeasible;
+    }
+
+    if (personGroups) {
+        *personGroups = QVector<int>(model.personCount + 1, -1);
+        for (int u = 0; u < units.size(); u++) {
+            for (int person : units[u].members) {
+                (*personGroups)[person] = unitGroup[u];
+            }
+        }
+    }
+    return Feasible;
+}
+
+bool ExactSolver::search(int depth)
+{
+    if (depth == order.size()) return true;
+    if (++nodeCount >= nodeLimit) return false;
+
+    int u = order[depth];
+    const Unit& unit = units[u];
+    int size = unit.members.size();
+
+    // 完全空的组只按座位数区分，座位数相同的空组只试第一个
+    QVector<int> triedEmptyCapacity;
+
+    for (int g = 0; g < model.groupCount; g++) {
+        if (unit.pinned >= 0 && g != unit.pinned) continue;
+        if (freeSeats[g] < size) continue;
+
+        if (freeSeats[g] == model.capacity[g]) {
+            if (triedEmptyCapacity.contains(model.capacity[g])) continue;
+            triedEmptyCapacity.append(model.capacity[g]);
+        }
+
+        bool clash = false;
+        for (int other : unit.conflicts) {
+            if (unitGroup[other] == g) {
+                clash = true;
+                break;
+            }
+        }
+        if (clash) continue;
+
+        unitGroup[u] = g;
+        freeSeats[g] -= size;
+        if (search(depth + 1)) return true;
+        freeSeats[g] += size;
+        unitGroup[u] = -1;
+
+        if (nodeCount >= nodeLimit) return false;
+    }
+
+    return false;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#ifndef EXACTSOLVER_H
+#define EXACTSOLVER_H
+
+#include <QVector>
+#include "problemmodel.h"
+
+// 硬性要求的精确可行性求解
+// 只考虑座位数、必须同组、不能同组和固定位置；配额、组长、外宿生等由评分处理。
+// 把合并后的同组集合以及出现在不能同组要求或固定位置中的人作为"单元"，
+// 用回溯搜索把单元分到各组，空组按座位数做对称性剪枝，其余的人只需座位总数足够即可放下
+class ExactSolver {
+public:
+    enum Result {
+        Feasible,
+        Infeasible,
+        Unknown     // 超出搜索节点上限
+    };
+
+    explicit ExactSolver(const ProblemModel& model);
+
+    // personGroups 非空时写入找到的方案：人员ID -> 本地组下标，不受约束的人为 -1
+    Result solve(int nodeLimit = 200000, QVector<int>* personGroups = nullptr);
+
+    int nodes() const { return nodeCount; }
+
+private:
+    struct Unit {
+        QVector<int> members;
+        int pinned = -1;       // 由固定位置确定的组，-1 表示任意
+        QVector<int> conflicts; // 不能与之同组的单元
+    };
+
+    bool search(int depth);
+
+    const ProblemModel& model;
+    QVector<Unit> units;
+    QVector<int> order;
+    QVector<int> unitGroup;
+    QVector<int> freeSeats;
+    bool trivialInfeasible = false;
+    int nodeCount = 0;
+    int nodeLimit = 0;
+};
+
+#endif // EXACTSOLVER_H
@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef GROUPKERNELS_H
+#define GROUPKERNELS_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+// 成对共现矩阵的下标（下三角压缩存储，人员ID从1开始），用 min/max 代替分支
+inline int pairIndex(int a, int b)
+{
+    int hi = std::max(a, b);
+    int lo = std::min(a, b);
+    return (hi - 1) * (hi - 2) / 2 + (lo - 1);
+}
+
+// 局部搜索的内层计算
+// 每个组按自己的人数选择实现：4、6、8人组使用编译期确定大小、展开循环的版本，其余大小使用通用循环。
+// 两种版本都直接读取组的 QVector 存储，允许组内有空位（0），不同大小的组可以混在同一方案中
+namespace GroupKernel {
+
+// 组内成员 other 对"把 out 换成 in"的代价贡献，other 是 out 本人或空位时为 0（不分支，下标先选到0再取数）
+inline int swapTerm(int other, int out, int in, const quint16* counts)
+{
+    bool skip = other == out || other == 0;
+    int gain = int(counts[skip ? 0 : pairIndex(in, other)]) - int(counts[skip ? 0 : pairIndex(out, other)]);
+    return skip ? 0 : gain;
+}
+
+template<std::size_t... I>
+inline int swapDeltaUnrolled(const int* members, int out, int in, const quint16* counts, std::index_sequence<I...>)
+{
+    return (swapTerm(members[I], out, in, counts) + ... + 0);
+}
+
+inline int swapDeltaGeneric(const int* members, int size, int out, int in, const quint16* counts)
+{
+    int delta = 0;
+    for (int i = 0; i < size; i++) {
+        delta += swapTerm(members[i], out, in, counts);
+    }
+    return delta;
+}
+
+// 组内的 out 换成 in 后，该组所有同组人员对的共现次数之和的变化
+inline int swapDelta(const QVector<int>& group, int out, int in, const quint16* counts)
+{
+    const int* members = group.constData();
+    switch (group.size()) {
+    case 4: return swapDeltaUnrolled(members, out, in, counts, std::make_index_sequence<4>());
+    case 6: return swapDeltaUnrolled(members, out, in, counts, std::make_index_sequence<6>());
+    case 8: return swapDeltaUnrolled(members, out, in, counts, std::make_index_sequence<8>());
+    default: return swapDeltaGeneric(members, group.size(), out, in, counts);
+    }
+}
+
+// 展开版本每个座位都写入 seats，只按条件推进计数，不分支
+template<class Pred, std::size_t... I>
+inline int collectSeatsUnrolled(const int* members, const Pred& pred, int* seats, std::index_sequence<I...>)
+{
+    int count = 0;
+    ((seats[count] = int(I), count += int(bool(pred(members[I])))), ...);
+    return count;
+}
+
+template<class Pred>
+inline int collectSeatsGeneric(const int* members, int size, const Pred& pred, int* seats)
+{
+    int count = 0;
+    for (int i = 0; i < size; i++) {
+        seats[count] = i;
+        count += int(bool(pred(members[i])));
+    }
+    return count;
+}
+
+// 按座位顺序把组内满足 pred 的座位号写入 seats，返回个数；seats 至少要有 group.size() 个位置
+template<class Pred>
+inline int collectSeats(const QVector<int>& group, const Pred& pred, int* seats)
+{
+    const int* members = group.constData();
+    switch (group.size()) {
+    case 4: return collectSeatsUnrolled(members, pred, seats, std::make_index_sequence<4>());
+    case 6: return collectSeatsUnrolled(members, pred, seats, std::make_index_sequence<6>());
+    case 8: return collectSeatsUnrolled(members, pred, seats, std::make_index_sequence<8>());
+    default: return collectSeatsGeneric(members, group.size(), pred, seats);
+    }
+}
+
+} // namespace GroupKernel
+
+#endif // GROUPKERNELS_H
@@ -0,0 +1,181 @@
+#include "grouptablemodel.h"
+#include <QColor>
+#include <QFont>
+
+namespace {
+
+const char* const PERSON_MIME_TYPE = "application/x-grouping-person";
+
+} // namespace
+
+GroupTableModel::GroupTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void GroupTableModel::setPeople(const QVector<PersonDisplay>& newPeople)
+{
+    if (newPeople == people) return;
+    people = newPeople;
+    if (!cells.isEmpty()) {
+        emit dataChanged(index(0, 1), index(rowLabels.size() - 1, seatColumns));
+    }
+}
+
+void GroupTableModel::setAssignment(const QStringList& newRowLabels, const QString& newLabelHeader,
+    const QString& newSeatHeader, int newSeatColumns, const QVector<QVector<int>>& rows)
+{
+    QVector<int> newCells(newRowLabels.size() * newSeatColumns, 0);
+    for (int r = 0; r < newRowLabels.size() && r < rows.size(); r++) {
+        for (int c = 0; c < rows[r].size() && c < newSeatColumns; c++) {
+            newCells[r * newSeatColumns + c] = rows[r][c];
+        }
+    }
+
+    // 结构变化时整体重置
+    if (newRowLabels != rowLabels || newSeatColumns != seatColumns ||
+        newLabelHeader != labelHeader || newSeatHeader != seatHeader) {
+        beginResetModel();
+        rowLabels = newRowLabels;
+        labelHeader = newLabelHeader;
+        seatHeader = newSeatHeader;
+        seatColumns = newSeatColumns;
+        cells = newCells;
+        endResetModel();
+        return;
+    }
+
+    // 结构不变：每行中连续变化的单元格合并为一次 dataChanged
+    for (int r = 0; r < rowLabels.size(); r++) {
+        int c = 0;
+        while (c < seatColumns) {
+            int at = r * seatColumns + c;
+            if (cells[at] == newCells[at]) {
+                c++;
+                continue;
+            }
+            int first = c;
+            while (c < seatColumns && cells[r * seatColumns + c] != newCells[r * seatColumns + c]) {
+                cells[r * seatColumns + c] = newCells[r * seatColumns + c];
+                c++;
+            }
+            emit dataChanged(index(r, first + 1), index(r, c));
+        }
+    }
+}
+
+void GroupTableModel::clear()
+{
+    beginResetModel();
+    rowLabels.clear();
+    cells.clear();
+    seatColumns = 0;
+    endResetModel();
+}
+
+int GroupTableModel::personAt(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.column() == 0 || index.row() >= rowLabels.size()) return 0;
+    return cells[index.row() * seatColumns + index.column() - 1];
+}
+
+int GroupTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : rowLabels.size();
+}
+
+int GroupTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : seatColumns + 1;
+}
+
+QVariant GroupTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    if (index.column() == 0) {
+        return role == Qt::DisplayRole ? QVariant(rowLabels[index.row()]) : QVariant();
+    }
+
+    int person = personAt(index);
+    if (person <= 0 || person >= people.size()) return QVariant();
+    const PersonDisplay& display = people[person];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return display.note.isEmpty() ? display.name : QString("%1\n%2").arg(display.name, display.note);
+    case Qt::BackgroundRole:
+        if (display.boarder) return QColor(Qt::yellow);
+        return display.male ? QColor(200, 230, 255) : QColor(255, 230, 255);
+    case Qt::FontRole:
+        if (display.leader) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+QVariant GroupTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    if (section == 0) return labelHeader;
+    return QString("%1%2").arg(seatHeader).arg(section);
+}
+
+// 拖放用复制动作：视图在移动动作结束后会删除源单元格，而这里的内容由调用方重新设置
+Qt::ItemFlags GroupTableModel::flags(const QModelIndex& index) const
+{
+    Qt::ItemFlags result = QAbstractTableModel::flags(index);
+    if (!movesEnabled || !index.isValid() || index.column() == 0) return result;
+    if (personAt(index) != 0) result |= Qt::ItemIsDragEnabled;
+    return result | Qt::ItemIsDropEnabled;
+}
+
+QStringList GroupTableModel::mimeTypes() const
+{
+    return { PERSON_MIME_TYPE };
+}
+
+QMimeData* GroupTableModel::mimeData(const QModelIndexList& indexes) const
+{
+    for (const QModelIndex& index : indexes) {
+        int person = personAt(index);
+        if (person == 0) continue;
+        QMimeData* data = new QMimeData();
+        data->setData(PERSON_MIME_TYPE, QByteArray::number(person));
+        return data;
+    }
+    return nullptr;
+}
+
+bool GroupTableModel::dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column,
+    const QModelIndex& parent)
+{
+    Q_UNUSED(action);
+    // 放在单元格上时 row、column 为 -1，目标在 parent 中
+    if (!movesEnabled || row != -1 || column != -1 || !parent.isValid() || parent.column() == 0) return false;
+    int person = draggedPerson(data);
+    if (person == 0) return false;
+    emit moveRequested(person, parent.row(), parent.column() - 1);
+    return true;
+}
+
+Qt::DropActions GroupTableModel::supportedDragActions() const
+{
+    return Qt::CopyAction;
+}
+
+Qt::DropActions GroupTableModel::supportedDropActions() const
+{
+    return Qt::CopyAction;
+}
+
+int GroupTableModel::draggedPerson(const QMimeData* data)
+{
+    if (!data || !data->hasFormat(PERSON_MIME_TYPE)) return 0;
+    return data->data(PERSON_MIME_TYPE).toInt();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef GROUPTABLEMODEL_H
+#define GROUPTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QMimeData>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// 表格中显示一个人所需的属性
+struct PersonDisplay {
+    QString name;
+    QString note;          // 名字下方的附加行（考场模式的属性），为空时不显示
+    bool male = false;
+    bool leader = false;   // 粗体
+    bool boarder = false;  // 黄色背景
+
+    bool operator==(const PersonDisplay& other) const {
+        return name == other.name && note == other.note && male == other.male &&
+            leader == other.leader && boarder == other.boarder;
+    }
+    bool operator!=(const PersonDisplay& other) const { return !(*this == other); }
+};
+
+// 分组结果表格的数据模型
+// 第0列是行标签（组号或排号），其余列是座位，座位内容以人员ID扁平存储（0 为空位）。
+// 行列结构不变时只对内容变化的单元格发出 dataChanged，文字、颜色、粗体在 data() 中按需计算，
+// 不为每个单元格保存条目对象。
+// 开启拖放后可把人拖到另一个单元格，模型本身不改内容，只发出 moveRequested 由调用方执行移动
+class GroupTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit GroupTableModel(QObject* parent = nullptr);
+
+    // 人员属性表，下标为人员ID
+    void setPeople(const QVector<PersonDisplay>& people);
+
+    // 设置表格内容：rowLabels 为各行标签，labelHeader 为第0列表头，
+    // 座位列表头为 seatHeader 加序号；rows 中不足 seatColumns 的部分视为空位
+    void setAssignment(const QStringList& rowLabels, const QString& labelHeader, const QString& seatHeader,
+        int seatColumns, const QVector<QVector<int>>& rows);
+
+    void clear();
+
+    // 单元格中的人员ID，标签列或空位返回 0
+    int personAt(const QModelIndex& index) const;
+
+    void setMovesEnabled(bool enabled) { movesEnabled = enabled; }
+    // 拖动数据中的人员ID，不是本模型产生的拖动返回 0
+    static int draggedPerson(const QMimeData* data);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    QStringList mimeTypes() const override;
+    QMimeData* mimeData(const QModelIndexList& indexes) const override;
+    bool dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column,
+        const QModelIndex& parent) override;
+    Qt::DropActions supportedDragActions() const override;
+    Qt::DropActions supportedDropActions() const override;
+
+signals:
+    // 把人拖到第 row 行第 seat 个座位（从0开始）
+    void moveRequested(int personId, int row, int seat);
+
+private:
+    QVector<PersonDisplay> people;
+    QStringList rowLabels;
+    QString labelHeader;
+    QString seatHeader;
+    int seatColumns = 0;
+    QVector<int> cells;    // 行优先，rowLabels.size() * seatColumns
+    bool movesEnabled = false;
+};
+
+#endif // GROUPTABLEMODEL_H
@@ -0,0 +1,253 @@
+#include "lnsengine.h"
+#include "groupkernels.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <climits>
+#include <iterator>
+#include <random>
+
+LnsEngine::LnsEngine(std::shared_ptr<const ProblemModel> problem, quint64 seed)
+    : model(std::move(problem)), rng(seed),
+    targets(arena.resource()), candidates(arena.resource()), removed(arena.resource()), seats(arena.resource()),
+    originalSeats(arena.resource()), classes(arena.resource()), personClass(arena.resource()),
+    classMembers(arena.resource()), freeMales(arena.resource()), freeFemales(arena.resource()),
+    assignment(arena.resource()), bestAssignment(arena.resource())
+{
+}
+
+LnsResult LnsEngine::run(const QVector<QVector<int>>& groups, qint64 timeBudgetMs, int maxIterations)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    LnsResult result;
+    current = groups;
+    score.build(model, current);
+    result.initialPenalty = score.total();
+
+    if (model->groupCount >= 2 && current.size() == model->groupCount) {
+        for (; result.iterations < maxIterations && score.total() > 0 && timer.elapsed() < timeBudgetMs &&
+            !(cancelToken && cancelToken->isCancelled());
+            result.iterations++) {
+            bool targetViolated = (rng() & 1) && !score.violatedGroups().isEmpty();
+            if (targetViolated) pickViolatedGroups(3); else pickRandomGroups(2);
+            if (destroyAndRepair()) {
+                result.improvements++;
+                if (snapshot) snapshot->offer(current, score.total());
+            }
+        }
+    }
+
+    result.groups = current;
+    result.finalPenalty = score.total();
+    result.interrupted = result.finalPenalty > 0 && result.iterations < maxIterations &&
+        model->groupCount >= 2 && current.size() == model->groupCount;
+    return result;
+}
+
+void LnsEngine::pickRandomGroups(int count)
+{
+    candidates.clear();
+    for (int g = 0; g < model->groupCount; g++) {
+        candidates.push_back(g);
+    }
+    std::shuffle(candidates.begin(), candidates.end(), rng);
+    targets.assign(candidates.begin(), candidates.begin() + qMin(count, int(candidates.size())));
+}
+
+// 一个违反要求的组，加上与其成员有共同要求的人所在的组
+void LnsEngine::pickViolatedGroups(int count)
+{
+    QVector<int> violated = score.violatedGroups();
+    int first = violated[std::uniform_int_distribution<int>(0, violated.size() - 1)(rng)];
+
+    candidates.clear();
+    auto addRelated = [&](IdRange members) {
+        for (int other : members) {
+            int g = score.groupOf(other);
+            if (g >= 0 && g != first && std::find(candidates.begin(), candidates.end(), g) == candidates.end()) {
+                candidates.push_back(g);
+            }
+        }
+        };
+    for (int person : current[first]) {
+        if (person == 0) continue;
+        for (int s : model->togetherSetsOf(person)) {
+            addRelated(model->togetherSet(s));
+        }
+        for (int s : model->separateSetsOf(person)) {
+            addRelated(model->separateSet(s));
+        }
+    }
+    std::shuffle(candidates.begin(), candidates.end(), rng);
+
+    targets.assign(1, first);
+    for (int g : candidates) {
+        if (int(targets.size()) >= count) break;
+        targets.push_back(g);
+    }
+    if (int(targets.size()) >= count) return;
+
+    // 相关的组不够时用随机组补足
+    candidates.clear();
+    for (int g = 0; g < model->groupCount; g++) {
+        if (std::find(targets.begin(), targets.end(), g) == targets.end()) candidates.push_back(g);
+    }
+    std::shuffle(candidates.begin(), candidates.end(), rng);
+    for (int g : candidates) {
+        if (int(targets.size()) >= count) break;
+        targets.push_back(g);
+    }
+}
+
+bool LnsEngine::destroyAndRepair()
+{
+    int before = score.total();
+    int k = int(targets.size());
+
+    // 拆除：目标组中所有可移动的人，记录原座位以便回退
+    removed.clear();
+    originalSeats.clear();
+    freeMales.assign(k, 0);
+    freeFemales.assign(k, 0);
+    auto isMovable = [&](int person) { return person != 0 && !model->isFixed(person); };
+    for (int t = 0; t < k; t++) {
+        int g = targets[t];
+        seats.resize(current[g].size());
+        int count = GroupKernel::collectSeats(current[g], isMovable, seats.data());
+        for (int i = 0; i < count; i++) {
+            int s = seats[i];
+            int person = current[g][s];
+            removed.push_back(person);
+            originalSeats.push_back({ g, s });
+            current[g][s] = 0;
+            score.applyMove(person, -1);
+            if (model->isMale(person)) freeMales[t]++; else freeFemales[t]++;
+        }
+    }
+
+    auto restore = [&]() {
+        for (int i = 0; i < int(removed.size()); i++) {
+            current[originalSeats[i].group][originalSeats[i].seat] = removed[i];
+            score.applyMove(removed[i], originalSeats[i].group);
+        }
+        };
+
+    if (removed.size() < 2) {
+        restore();
+        return false;
+    }
+
+    // 分类：有要求的人单独成类，其余按性别、组长、外宿生合并（键只有3位，用定长表代替映射）。
+    // 各类成员在 classMembers 中连续存放：先记下每人所属的类并计数，再按各类起点填入
+    classes.clear();
+    personClass.clear();
+    int classOfKey[8];
+    std::fill(std::begin(classOfKey), std::end(classOfKey), -1);
+    for (int person : removed) {
+        bool constrained = !model->togetherSetsOf(person).isEmpty() || !model->separateSetsOf(person).isEmpty();
+        int key = (model->isMale(person) ? 1 : 0) | (model->isLeader(person) ? 2 : 0) | (model->isBoarder(person) ? 4 : 0);
+        if (constrained || classOfKey[key] < 0) {
+            if (!constrained) classOfKey[key] = int(classes.size());
+            classes.push_back({ 0, 0, model->isMale(person) });
+        }
+        int c = constrained ? int(classes.size()) - 1 : classOfKey[key];
+        classes[c].size++;
+        personClass.push_back(c);
+    }
+    int begin = 0;
+    for (PersonClass& cls : classes) {
+        cls.begin = begin;
+        begin += cls.size;
+        cls.size = 0;
+    }
+    classMembers.assign(removed.size(), 0);
+    for (int i = 0; i < int(removed.size()); i++) {
+        PersonClass& cls = classes[personClass[i]];
+        classMembers[cls.begin + cls.size++] = removed[i];
+    }
+
+    // 修复：精确枚举
+    assignment.assign(classes.size() * k, 0);
+    bestAssignment.clear();
+    bestPenalty = INT_MAX;
+    leaves = 0;
+    searchRepair(0, 0, classes[0].size);
+
+    if (bestAssignment.empty() || bestPenalty > before) {
+        restore();
+        return false;
+    }
+
+    auto isEmptySeat = [](int person) { return person == 0; };
+    for (int t = 0; t < k; t++) {
+        int g = targets[t];
+        seats.resize(current[g].size());
+        GroupKernel::collectSeats(current[g], isEmptySeat, seats.data());
+        int next = 0;
+        for (int c = 0; c < int(classes.size()); c++) {
+            int offset = 0;
+            for (int u = 0; u < t; u++) {
+                offset += bestAssignment[c * k + u];
+            }
+            for (int n = 0; n < bestAssignment[c * k + t]; n++) {
+                int person = classMembers[classes[c].begin + offset + n];
+                current[g][seats[next++]] = person;
+                score.applyMove(person, g);
+            }
+        }
+    }
+
+    return score.total() < before;
+}
+
+// 依次决定第 classIdx 类人在第 targetIdx 个目标组放几个，remaining 为该类尚未放置的人数
+void LnsEngine::searchRepair(int classIdx, int targetIdx, int remaining)
+{
+    if (classIdx == int(classes.size())) {
+        leaves++;
+        if (score.total() < bestPenalty) {
+            bestPenalty = score.total();
+            bestAssignment = assignment;
+        }
+        return;
+    }
+    if (leaves >= leafLimit) return;
+
+    const PersonClass& cls = classes[classIdx];
+    ArenaVector<int>& freeSlots = cls.male ? freeMales : freeFemales;
+    int k = int(targets.size());
+    int first = cls.begin + cls.size - remaining;
+
+    auto place = [&](int n) {
+        for (int i = 0; i < n; i++) {
+            score.applyMove(classMembers[first + i], targets[targetIdx]);
+        }
+        freeSlots[targetIdx] -= n;
+        assignment[classIdx * k + targetIdx] = n;
+        };
+    auto unplace = [&](int n) {
+        for (int i = 0; i < n; i++) {
+            score.applyMove(classMembers[first + i], -1);
+        }
+        freeSlots[targetIdx] += n;
+        assignment[classIdx * k + targetIdx] = 0;
+        };
+
+    // 最后一个目标组放下该类剩余的所有人
+    if (targetIdx == k - 1) {
+        if (freeSlots[targetIdx] < remaining) return;
+        place(remaining);
+        int next = classIdx + 1;
+        searchRepair(next, 0, next < int(classes.size()) ? classes[next].size : 0);
+        unplace(remaining);
+        return;
+    }
+
+    for (int n = qMin(remaining, freeSlots[targetIdx]); n >= 0; n--) {
+        place(n);
+        searchRepair(classIdx, targetIdx + 1, remaining - n);
+        unplace(n);
+        if (leaves >= leafLimit) return;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#ifndef LNSENGINE_H
+#define LNSENGINE_H
+
+#include <QVector>
+#include <memory>
+#include "problemmodel.h"
+#include "assignmentscore.h"
+#include "canceltoken.h"
+#include "solutionsnapshot.h"
+#include "counterrng.h"
+#include "solverarena.h"
+
+struct LnsResult {
+    QVector<QVector<int>> groups;
+    int initialPenalty = 0;
+    int finalPenalty = 0;
+    int iterations = 0;
+    int improvements = 0;
+    bool interrupted = false;   // 因时限或取消在迭代次数用完之前停止
+};
+
+// 大邻域搜索
+// 每轮拆出几个组（随机选取，或选违反要求的组及与之相关的组）中所有可移动的人，
+// 再对这一小块子问题做精确求解后放回。与跨组交换一样，各组的男女人数保持不变，固定位置的人不动。
+// 子问题中属性完全相同（性别、组长、外宿生都一致且不在任何要求中）的人视为可互换，
+// 只枚举每类人在各组的人数，节点数超过上限时取已找到的最好方案
+class LnsEngine {
+public:
+    LnsEngine(std::shared_ptr<const ProblemModel> model, quint64 seed);
+
+    LnsResult run(const QVector<QVector<int>>& groups, qint64 timeBudgetMs, int maxIterations = 100000);
+
+    int leafLimit = 20000;
+    const CancelToken* cancelToken = nullptr;
+    SolutionSnapshot* snapshot = nullptr;  // 非空时每次改进都发布当前方案
+
+private:
+    void pickRandomGroups(int count);
+    void pickViolatedGroups(int count);
+    bool destroyAndRepair();
+    void searchRepair(int classIdx, int targetIdx, int remaining);
+
+    std::shared_ptr<const ProblemModel> model;
+    CounterRng rng;
+
+    QVector<QVector<int>> current;
+    AssignmentScore score;
+
+    // 子问题，每轮 clear() 后复用，内存来自本次运行的 arena
+    struct PersonClass {
+        int begin;    // 成员在 classMembers 中的起始下标
+        int size;
+        bool male;
+    };
+    struct Seat {
+        int group;
+        int seat;
+    };
+    SolverArena arena;
+    ArenaVector<int> targets;
+    ArenaVector<int> candidates;      // 选目标组时的候选组
+    ArenaVector<int> removed;
+    ArenaVector<int> seats;           // GroupKernel::collectSeats 选出的座位号
+    ArenaVector<Seat> originalSeats;
+    ArenaVector<PersonClass> classes;
+    ArenaVector<int> personClass;     // removed 中每人所属的类
+    ArenaVector<int> classMembers;
+    ArenaVector<int> freeMales;
+    ArenaVector<int> freeFemales;
+    ArenaVector<int> assignment;      // 当前分支中每类人在各目标组的人数（扁平存储）
+    ArenaVector<int> bestAssignment;
+    int bestPenalty = 0;
+    int leaves = 0;
+};
+
+#endif // LNSENGINE_H
@@ -5,6 +5,7 @@
 
 #include <QMainWindow>
 #include <QTableWidget>
+#include <QTableView>
 #include <QGroupBox>
 #include <QPushButton>
 #include <QTextEdit>
@@ -49,6 +50,23 @@
 #include <QVersionNumber>
 #include <QTimer>
 #include <QDate>
+#include "seatinghistory.h"
+#include "problemmodel.h"
+#include "exactsolver.h"
+#include "assignmentscore.h"
+#include "canceltoken.h"
+#include "solutionsnapshot.h"
+#include "portfolio.h"
+#include "counterrng.h"
+#include "grouptablemodel.h"
+#include "seatmapwidget.h"
+#include "swapadvisor.h"
+#include "edithistory.h"
+#include "solverarena.h"
+#include <QElapsedTimer>
+#include <memory>
+#include <thread>
+#include <functional>
 
 // 分组配置结构体
 struct GroupConfig {
@@ -86,15 +104,27 @@ struct Position {
     }
 };
 
-// 交换状态结构体
+// 交换路径搜索的一个状态：起点的人当前所在座位，以及到达这里的最后一次交换。
+// 路径沿 parent 回溯得到，不在每个状态里复制
 struct SwapState {
     int group;
     int seat;
-    QVector<QPair<Position, Position>> path;
+    int parent;                      // 上一状态在搜索数组中的下标，起点为 -1
+    QPair<Position, Position> swap;
+};
 
-    SwapState(int g, int s, const QVector<QPair<Position, Position>>& p = {})
-        : group(g), seat(s), path(p) {
-    }
+// 手动移动的执行方案：目标是同组座位或同性别的人时一次交换；
+// 否则先与目标组中代价最小的同性别成员交换，再在组内换到目标座位
+struct ManualMove {
+    bool allowed = false;
+    QString reason;                 // 不能移动的原因
+    int person = 0;
+    int partner = 0;                // 跨组交换的对象，0 表示只在组内换座
+    QVector<QPair<Position, Position>> steps;
+    int penaltyDelta = 0;
+    QStringList satisfied;          // 移动后变为满足的要求
+    QStringList broken;             // 移动后变为违反的要求
+    QStringList warnings;
 };
 
 class MainWindow : public QMainWindow {
@@ -106,6 +136,9 @@ public:
     QStringList getMaleNames() const { return male_names; }
     QStringList getFemaleNames() const { return female_names; }
 
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 private slots:
     void addConstraint();
     void removeConstraint();
@@ -126,6 +159,14 @@ private slots:
     void checkForUpdates(bool silent = false);
     void manualUpdateCheck(bool silent);
     void manualUpdateCheck();
+    void showExamDialog();
+    void showRotationDialog();
+    void showHistoryDialog();
+    void minimalDisruptionReseat();
+    void refreshBackgroundSolve();
+    void stopBackgroundSolve();
+    void undoEdit();
+    void redoEdit();
 
 private:
     // 初始化函数
@@ -141,6 +182,7 @@ private:
     void showUpdateDialog(const QString& latestVersion, const QString& downloadUrl, const QString& releaseNotes);
     QMenu* groupTableContextMenu;
     QAction* moveToSeatAction;
+    QAction* suggestSwapAction;
 
     // 分组算法相关函数
     QPair<QVector<QVector<int>>, QSet<int>> initializeGroupsWithConstraints();
@@ -153,27 +195,71 @@ private:
     void showConstraintViolations();
     GroupConfig getGroupConfigForIndex(int index);
 
+    // 考场模式相关函数
+    QVector<int> solveExamSeating(const QVector<int>& studentClass, int rows, int cols, bool eightNeighbors);
+    void generateExamSeating();
+    void printExamGrid();
+    int countExamConflicts();
+
+    // 轮换计划相关函数
+    void generateRotationPlan(int weekCount);
+
+    // 分组历史相关函数
+    QByteArray currentConfigJson();
+    void recordSeatingHistory(const QString& label, quint64 seed);
+
     // 导出相关函数
     void doExportSeatingPlan(const QString& fileName);
 
     // 辅助函数
     QChar getGender(int person);
     void printGroups();
+    QVector<PersonDisplay> personDisplays(bool examNotes);
     void someFunction();
 
     // 位置交换相关函数
     bool swapPersonsInGroup(int groupIndex, int seatA, int seatB);
     bool swapPersonsBetweenGroups(int groupA, int seatA, int groupB, int seatB);
-    bool movePersonToPosition(int personId, int targetGroup, int targetSeat);
+
+    // 批量交换：先在副本上检查全部交换，全部合法才一次写回
+    bool applySwapsTo(QVector<QVector<int>>& state, const QVector<QPair<Position, Position>>& swaps,
+        QString* error = nullptr);
+    bool applySwapBatch(const QVector<QPair<Position, Position>>& swaps, bool refresh, QString* error = nullptr);
+
+    // 手动移动（拖放、右键菜单）：开始时按当前分组建立增量评分，悬停时只试算涉及的两个人
+    void prepareManualMove();
+    ManualMove planManualMove(int personId, int targetGroup, int targetSeat);
+    QString describeManualMove(const ManualMove& move);
+    bool applyManualMove(const ManualMove& move);
+    void requestManualMove(int personId, int targetGroup, int targetSeat);
+    void showSwapSuggestions(int personId, const QPoint& globalPos);
+    void jumpToEdit(int step);
+    void updateEditActions();
 
     // 添加网络管理器和版本检查相关成员
     QNetworkAccessManager* networkManager;
     bool isCheckingUpdates;
-    QVector<QPair<Position, Position>> findSwapPath(int startGroup, int startSeat, int targetGroup, int targetSeat);
-    void optimizeFixedPositions();
+    // compileProblemModel 的结果，名单、分组设置、要求条件或固定位置改变时由 invalidateProblemModel 清除
+    std::shared_ptr<const ProblemModel> problemModelCache;
+    QVector<QPair<Position, Position>> findSwapPath(const QVector<QVector<int>>& state, int startGroup, int startSeat, int targetGroup, int targetSeat);
+    void optimizeFixedPositions(QVector<QVector<int>>& state, const ProblemModel& model);
+    ProblemInput problemInput();
+    std::shared_ptr<const ProblemModel> compileProblemModel();
+    void invalidateProblemModel();
+    bool reportProblemConflicts(const ProblemModel& model,
+        const std::function<bool(const ProblemConflict&)>& relevant = nullptr);
+    bool explainConflicts();
+    bool incrementalResolve(const QVector<QStringList>& previousGroupNames);
+    bool startBackgroundSolve(qint64 timeBudgetMs);
+    void finishBackgroundSolve();
+    bool solveRunning() const;
+    void abortBackgroundSolve();
+    void setSolveLocked(bool locked);
 
     // UI组件
-    QTableWidget* groupTable;
+    QTableView* groupTable;
+    GroupTableModel* groupModel;
+    SeatMapWidget* seatMap;
     QTableWidget* constraintTable;
     QTableWidget* fixedPositionTable;
     QTextEdit* logOutput;
@@ -186,6 +272,9 @@ private:
     QPushButton* personnelCheckBtn;
     QPushButton* checkBtn;
     QPushButton* resetBtn;
+    QPushButton* reseatBtn;
+    QComboBox* reseatMetricCombo;
+    QPushButton* stopSolveBtn;
     QLabel* statusLabel;
     QMenu* fileMenu;
 
@@ -202,11 +291,49 @@ private:
     QSet<QString> boarders;
     QVector<GroupConfig> groupConfigs;
     int actualGroupCount;
-    int findSameGenderInGroup(int person, int target_group_idx, const QSet<int>& fixed_people);
+    int findSameGenderInGroup(int person, int target_group_idx, const ArenaVector<char>& fixed_people);
 
     // 固定位置相关
     QMap<int, FixedPosition> fixedPositions;
 
+    // 考场模式相关
+    bool examMode;
+    int examRows;
+    int examCols;
+    bool examEightNeighbors;
+    QMap<QString, QString> examAttributes;
+
+    // 多周轮换计划
+    QVector<QVector<QVector<int>>> rotationPlans;
+
+    // 分组历史
+    SeatingHistory seatingHistory;
+    QSet<int> frontGroupNumbers;
+    quint32 lastSeed;
+    quint64 sameGenderDraws;   // findSameGenderInGroup 已从随机数流中取出的个数
+
+    // 后台求解（逐步显示当前最好结果）
+    QTimer* solveRefreshTimer;
+    std::thread solveThread;
+    std::shared_ptr<CancelToken> solveCancel;
+    std::shared_ptr<SolutionSnapshot> solveSnapshot;
+    std::shared_ptr<PortfolioResult> solveResult;
+    quint64 solveSnapshotVersion;
+    QElapsedTimer solveTimer;
+    QVector<QVector<int>> solveStart;       // 求解起点，结果人员与之不符时丢弃
+    QList<QAction*> solveLockedActions;     // 求解期间禁用的菜单项（会改动分组或设置）
+
+    // 手动移动的增量评分，与 groups 同步维护
+    std::shared_ptr<const ProblemModel> manualModel;
+    AssignmentScore manualScore;
+    Position manualHoverCell;
+
+    // 手动调整的撤销/重做
+    EditHistory editHistory;
+    QAction* undoAction;
+    QAction* redoAction;
+    QMenu* editHistoryMenu;
+
     // 样式和模板相关
     QString currentTemplatePath;
     QString currentStyle;
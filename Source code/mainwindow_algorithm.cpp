@@ -1,4 +1,7 @@
 #include "mainwindow.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include "allocstats.h"
 #include <algorithm>
 #include <iterator>
 #include <random>
@@ -15,158 +18,197 @@
 
 QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstraints()
 {
-    // 确定启用的组
-    QVector<int> enabledGroups;
-    for (int i = 0; i < 10; i++) {
-        if (groupConfigs[i].enabled) {
-            enabledGroups.append(i);
-        }
-    }
+    // 编译只读问题模型，启用的组及其本地下标直接取自模型；编译时同时完成可行性预检查
+    QElapsedTimer precheckTimer;
+    precheckTimer.start();
+    PhaseProfiler profiler;
+    profiler.begin("预检查");
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    const QVector<int>& enabledGroups = model->enabledGroups;
 
     if (enabledGroups.isEmpty()) {
         QMessageBox::warning(this, "错误", "没有启用的分组");
         return { QVector<QVector<int>>(), QSet<int>() };
     }
 
+    // 预检查要求条件，发现必然无法满足的矛盾时直接返回
+    bool feasible = reportProblemConflicts(*model);
+    if (feasible && ExactSolver(*model).solve() == ExactSolver::Infeasible) {
+        feasible = false;
+    }
+    qint64 precheckNs = precheckTimer.nsecsElapsed();
+    if (!feasible) {
+        logOutput->append(QString("预检查未通过，未开始分组 (用时 %1 μs)").arg(precheckNs / 1000));
+        explainConflicts();
+        QMessageBox::warning(this, "错误", "分组设置或要求条件存在矛盾，详见日志");
+        return { QVector<QVector<int>>(), QSet<int>() };
+    }
+
     // 初始化分组数据结构
     QVector<QVector<int>> local_groups(enabledGroups.size());
     for (int i = 0; i < local_groups.size(); i++) {
-        int group_idx = enabledGroups[i];
-        local_groups[i] = QVector<int>(groupConfigs[group_idx].total, 0);
+        local_groups[i] = QVector<int>(model->capacity[i], 0);
     }
 
     QSet<int> local_special_groups;
 
-    // 创建人员集合
-    QSet<int> all_people;
-    for (int i = 1; i <= male_names.size() + female_names.size(); i++) {
-        all_people.insert(i);
-    }
+    // 本次构造的人员标记和映射都按人员ID存放在同一个 arena 上，返回时一次性释放；
+    // 轮换计划每周调用一次，不再为每个集合的节点单独向堆申请
+    SolverArena arena;
+    const int personCount = model->personCount;
 
-    // 创建随机数生成器
-    std::random_device rd;
-    std::mt19937 g(rd());
+    // 尚未分配的人员
+    ArenaVector<char> all_people(personCount + 1, 1, arena.resource());
+    all_people[0] = 0;
+
+    // 每次生成取一个新的根种子并写入分组历史；构造过程和组内随机挑选各用由它派生的计数器式随机数流，
+    // 同一种子可以完全重放
+    lastSeed = QRandomGenerator::global()->generate();
+    CounterRng g(lastSeed, 0, RngPhase::Construct);
+    sameGenderDraws = 0;
 
     // 第一步：最高优先级
-    QSet<int> fixed_people;
+    profiler.begin("固定位置");
+    ArenaVector<char> fixed_people(personCount + 1, 0, arena.resource());
 
-    // 按组号排序处理固定位置，确保前面的组先处理
-    QList<int> fixedPersonIds = fixedPositions.keys();
-    std::sort(fixedPersonIds.begin(), fixedPersonIds.end(), [&](int a, int b) {
-        return fixedPositions[a].groupNumber < fixedPositions[b].groupNumber;
+    // 按组号排序处理固定位置，确保前面的组先处理；组未启用或座位越界已在预检查中报告
+    QVector<int> fixedPersonIds;
+    for (int id = 1; id <= model->personCount; id++) {
+        if (model->isFixed(id)) fixedPersonIds.append(id);
+    }
+    std::stable_sort(fixedPersonIds.begin(), fixedPersonIds.end(), [&](int a, int b) {
+        return model->fixedGroup(a) < model->fixedGroup(b);
         });
 
     for (int personId : fixedPersonIds) {
-        FixedPosition fixedPos = fixedPositions[personId];
-        int groupNumber = fixedPos.groupNumber;
-        int seatPosition = fixedPos.seatPosition;
-        int groupIdx = groupNumber - 1;
+        int localIdx = model->fixedGroup(personId);
+        int seatIndex = model->fixedSeat(personId);
+        if (localIdx == -1 || seatIndex < 0 || seatIndex >= local_groups[localIdx].size()) {
+            logOutput->append(QString("错误: %1 的固定位置无效").arg(id_to_name[personId]));
+            continue;
+        }
+        int groupNumber = model->groupNumber(localIdx);
+        int seatPosition = seatIndex + 1;
 
         logOutput->append(QString("处理固定位置: %1 到组%2座位%3")
             .arg(id_to_name[personId]).arg(groupNumber).arg(seatPosition));
 
-        // 检查组是否启用
-        if (groupIdx >= 0 && groupIdx < 10 && groupConfigs[groupIdx].enabled) {
-            int localIdx = enabledGroups.indexOf(groupIdx);
-            if (localIdx != -1) {
-                // 检查座位位置是否有效
-                if (seatPosition >= 1 && seatPosition <= local_groups[localIdx].size()) {
-                    int seatIndex = seatPosition - 1;
-
-                    // 检查目标座位是否已被占用
-                    if (local_groups[localIdx][seatIndex] != 0) {
-                        int occupiedPerson = local_groups[localIdx][seatIndex];
-
-                        if (fixed_people.contains(occupiedPerson)) {
-                            logOutput->append(QString("错误: 座位%1已被固定位置人员 %2 占用，无法放置 %3")
-                                .arg(seatPosition).arg(id_to_name[occupiedPerson]).arg(id_to_name[personId]));
-                            continue;
-                        }
+        // 检查目标座位是否已被占用
+        if (local_groups[localIdx][seatIndex] != 0) {
+            int occupiedPerson = local_groups[localIdx][seatIndex];
 
-                        // 移动占用者到其他空位
-                        bool moved = false;
-                        QString movedLog;
+            if (fixed_people[occupiedPerson]) {
+                logOutput->append(QString("错误: 座位%1已被固定位置人员 %2 占用，无法放置 %3")
+                    .arg(seatPosition).arg(id_to_name[occupiedPerson]).arg(id_to_name[personId]));
+                continue;
+            }
 
-                        // 首先尝试同组其他空位
-                        for (int j = 0; j < local_groups[localIdx].size() && !moved; j++) {
-                            if (local_groups[localIdx][j] == 0 && j != seatIndex) {
-                                local_groups[localIdx][j] = occupiedPerson;
-                                moved = true;
-                                movedLog = QString("同组移动到座位%1").arg(j + 1);
-                            }
-                        }
+            // 移动占用者到其他空位
+            bool moved = false;
+            QString movedLog;
+
+            // 首先尝试同组其他空位
+            for (int j = 0; j < local_groups[localIdx].size() && !moved; j++) {
+                if (local_groups[localIdx][j] == 0 && j != seatIndex) {
+                    local_groups[localIdx][j] = occupiedPerson;
+                    moved = true;
+                    movedLog = QString("同组移动到座位%1").arg(j + 1);
+                }
+            }
 
-                        // 如果同组没有空位，尝试其他组
-                        if (!moved) {
-                            for (int otherGroup = 0; otherGroup < local_groups.size() && !moved; otherGroup++) {
-                                if (otherGroup == localIdx) continue;
-
-                                for (int j = 0; j < local_groups[otherGroup].size() && !moved; j++) {
-                                    if (local_groups[otherGroup][j] == 0) {
-                                        local_groups[otherGroup][j] = occupiedPerson;
-                                        moved = true;
-                                        movedLog = QString("移动到组%1座位%2").arg(otherGroup + 1).arg(j + 1);
-                                    }
-                                }
-                            }
-                        }
+            // 如果同组没有空位，尝试其他组
+            if (!moved) {
+                for (int otherGroup = 0; otherGroup < local_groups.size() && !moved; otherGroup++) {
+                    if (otherGroup == localIdx) continue;
 
-                        if (moved) {
-                            logOutput->append(QString("移动 %1 %2").arg(id_to_name[occupiedPerson]).arg(movedLog));
-                        }
-                        else {
-                            logOutput->append(QString("错误: 无法为 %1 找到空座位，固定位置分配失败")
-                                .arg(id_to_name[occupiedPerson]));
-                            continue;
+                    for (int j = 0; j < local_groups[otherGroup].size() && !moved; j++) {
+                        if (local_groups[otherGroup][j] == 0) {
+                            local_groups[otherGroup][j] = occupiedPerson;
+                            moved = true;
+                            movedLog = QString("移动到组%1座位%2").arg(otherGroup + 1).arg(j + 1);
                         }
                     }
-
-                    // 分配固定位置
-                    local_groups[localIdx][seatIndex] = personId;
-                    fixed_people.insert(personId);
-                    all_people.remove(personId);
-
-                    logOutput->append(QString("成功分配固定位置: %1 到组%2座位%3")
-                        .arg(id_to_name[personId]).arg(groupNumber).arg(seatPosition));
-                }
-                else {
-                    logOutput->append(QString("错误: 座位位置%1超出范围(1-%2)")
-                        .arg(seatPosition).arg(local_groups[localIdx].size()));
                 }
             }
+
+            if (moved) {
+                logOutput->append(QString("移动 %1 %2").arg(id_to_name[occupiedPerson]).arg(movedLog));
+            }
             else {
-                logOutput->append(QString("错误: 组%1未启用").arg(groupNumber));
+                logOutput->append(QString("错误: 无法为 %1 找到空座位，固定位置分配失败")
+                    .arg(id_to_name[occupiedPerson]));
+                continue;
             }
         }
-        else {
-            logOutput->append(QString("错误: 组%1未启用或索引无效").arg(groupNumber));
-        }
+
+        // 分配固定位置
+        local_groups[localIdx][seatIndex] = personId;
+        fixed_people[personId] = 1;
+        all_people[personId] = 0;
+
+        logOutput->append(QString("成功分配固定位置: %1 到组%2座位%3")
+            .arg(id_to_name[personId]).arg(groupNumber).arg(seatPosition));
     }
 
     // 第二步：处理必须同组的要求
-    QSet<int> constrained_people;
+    profiler.begin("必须同组");
+    ArenaVector<char> constrained_people(personCount + 1, 0, arena.resource());
 
-    // 为要求组预分配组
+    // 为要求组预分配组：有共同成员的要求已在模型中合并，
+    // 每个合并后的集合放入一个能容纳它的组，含固定位置成员的集合放入固定位置所在的组
     QVector<int> available_groups = enabledGroups;
     std::shuffle(available_groups.begin(), available_groups.end(), g);
 
     QSet<int> constrained_groups;
 
-    for (int i = 0; i < must_together_groups.size(); i++) {
-        if (available_groups.isEmpty()) {
+    auto emptySeats = [&](int local_idx) {
+        return int(std::count(local_groups[local_idx].begin(), local_groups[local_idx].end(), 0));
+        };
+
+    // 人数多的集合先分配
+    QVector<int> clusterOrder;
+    for (int c = 0; c < model->clusterCount(); c++) {
+        clusterOrder.append(c);
+    }
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](int a, int b) {
+        return model->cluster(a).size() > model->cluster(b).size();
+        });
+
+    for (int c : clusterOrder) {
+        int unplaced = 0;
+        for (int person : model->cluster(c)) {
+            if (!fixed_people[person]) unplaced++;
+        }
+
+        int local_idx = model->clusterGroup(c);
+        if (local_idx == -1) {
+            for (int group_index : available_groups) {
+                int candidate = model->localGroupOf(group_index);
+                if (model->clusterFits(c, candidate) && emptySeats(candidate) >= unplaced) {
+                    local_idx = candidate;
+                    break;
+                }
+            }
+            // 配额不满足时退而只看空位
+            for (int k = 0; k < available_groups.size() && local_idx == -1; k++) {
+                int candidate = model->localGroupOf(available_groups[k]);
+                if (emptySeats(candidate) >= unplaced) local_idx = candidate;
+            }
+        }
+        if (local_idx == -1) {
             logOutput->append("错误：没有足够的组来分配所有要求组");
             break;
         }
 
-        int group_index = available_groups.takeFirst();
+        int group_index = enabledGroups[local_idx];
+        available_groups.removeOne(group_index);
         constrained_groups.insert(group_index);
-        int local_idx = enabledGroups.indexOf(group_index);
 
         // 为要求组分配位置，从第一个座位开始顺序分配
         int currentSeat = 0;
-        for (int person : must_together_groups[i]) {
+        for (int person : model->cluster(c)) {
             // 如果人员已经被固定位置占用，跳过
-            if (fixed_people.contains(person)) {
+            if (fixed_people[person]) {
                 logOutput->append(QString("人员 %1 已被固定位置占用，跳过要求分配").arg(id_to_name[person]));
                 continue;
             }
@@ -179,8 +221,8 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
 
             if (currentSeat < local_groups[local_idx].size()) {
                 local_groups[local_idx][currentSeat] = person;
-                constrained_people.insert(person);
-                all_people.remove(person);
+                constrained_people[person] = 1;
+                all_people[person] = 0;
                 currentSeat++;
             }
             else {
@@ -191,11 +233,13 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     }
 
     // 分离男女生
+    profiler.begin("性别配额");
     QVector<int> free_males;
     QVector<int> free_females;
 
-    for (int person : all_people) {
-        if (person <= male_names.size()) {
+    for (int person = 1; person <= personCount; person++) {
+        if (!all_people[person]) continue;
+        if (model->isMale(person)) {
             free_males.append(person);
         }
         else {
@@ -216,13 +260,12 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
             continue;
         }
 
-        GroupConfig config = groupConfigs[group_idx];
         int current_females = 0;
         for (int person : local_groups[local_idx]) {
-            if (person != 0 && getGender(person) == 'F') current_females++;
+            if (person != 0 && !model->isMale(person)) current_females++;
         }
 
-        int need = config.females - current_females;
+        int need = model->quotaFemales[local_idx] - current_females;
         if (need > 0) {
             for (int j = 0; j < need && !free_females.isEmpty(); j++) {
                 // 找到第一个空位
@@ -251,13 +294,12 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
             continue;
         }
 
-        GroupConfig config = groupConfigs[group_idx];
         int current_males = 0;
         for (int person : local_groups[local_idx]) {
-            if (person != 0 && getGender(person) == 'M') current_males++;
+            if (person != 0 && model->isMale(person)) current_males++;
         }
 
-        int need = config.males - current_males;
+        int need = model->quotaMales[local_idx] - current_males;
         if (need > 0) {
             for (int j = 0; j < need && !free_males.isEmpty(); j++) {
                 // 找到第一个空位
@@ -334,26 +376,25 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     }
 
     // 第五步：重新设计组长分配逻辑，确保每组最多一个组长
+    profiler.begin("组长");
     QVector<int> availableLeaders;
-    for (const QString& leaderName : leaders) {
-        if (name_to_id.contains(leaderName)) {
-            int leaderId = name_to_id[leaderName];
-            // 检查该组长是否已被分配
-            bool alreadyAssigned = false;
-            for (int i = 0; i < local_groups.size() && !alreadyAssigned; i++) {
-                for (int person : local_groups[i]) {
-                    if (person == leaderId) {
-                        alreadyAssigned = true;
-                        break;
-                    }
+    for (int leaderId = 1; leaderId <= model->personCount; leaderId++) {
+        if (!model->isLeader(leaderId)) continue;
+        // 检查该组长是否已被分配
+        bool alreadyAssigned = false;
+        for (int i = 0; i < local_groups.size() && !alreadyAssigned; i++) {
+            for (int person : local_groups[i]) {
+                if (person == leaderId) {
+                    alreadyAssigned = true;
+                    break;
                 }
             }
-            if (!alreadyAssigned) {
-                availableLeaders.append(leaderId);
-            }
-            else {
-                logOutput->append(QString("组长 %1 已被分配").arg(leaderName));
-            }
+        }
+        if (!alreadyAssigned) {
+            availableLeaders.append(leaderId);
+        }
+        else {
+            logOutput->append(QString("组长 %1 已被分配").arg(id_to_name[leaderId]));
         }
     }
 
@@ -363,7 +404,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     QVector<bool> groupHasLeader(local_groups.size(), false);
     for (int i = 0; i < local_groups.size(); i++) {
         for (int person : local_groups[i]) {
-            if (person != 0 && leaders.contains(id_to_name[person])) {
+            if (person != 0 && model->isLeader(person)) {
                 groupHasLeader[i] = true;
                 logOutput->append(QString("组%1 已有组长: %2").arg(i + 1).arg(id_to_name[person]));
                 break;
@@ -416,7 +457,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
 
         for (int i = 0; i < local_groups.size(); i++) {
             for (int j = 0; j < local_groups[i].size(); j++) {
-                if (local_groups[i][j] != 0 && leaders.contains(id_to_name[local_groups[i][j]])) {
+                if (local_groups[i][j] != 0 && model->isLeader(local_groups[i][j])) {
                     leaderCounts[i]++;
                     leaderPositions[i].append(j);
                 }
@@ -453,7 +494,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
                 int leaderId = local_groups[sourceGroup][leaderPos];
 
                 // 跳过固定位置的组长
-                if (fixed_people.contains(leaderId)) {
+                if (fixed_people[leaderId]) {
                     continue;
                 }
 
@@ -493,7 +534,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
                     int leaderId = local_groups[sourceGroup][leaderPos];
 
                     // 跳过固定位置的组长
-                    if (fixed_people.contains(leaderId)) {
+                    if (fixed_people[leaderId]) {
                         continue;
                     }
 
@@ -501,9 +542,9 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
                     for (int targetGroup : groupsWithoutLeaders) {
                         for (int k = 0; k < local_groups[targetGroup].size(); k++) {
                             int targetPerson = local_groups[targetGroup][k];
-                            if (targetPerson != 0 && !leaders.contains(id_to_name[targetPerson]) &&
-                                !fixed_people.contains(targetPerson) &&
-                                getGender(leaderId) == getGender(targetPerson)) {
+                            if (targetPerson != 0 && !model->isLeader(targetPerson) &&
+                                !fixed_people[targetPerson] &&
+                                model->isMale(leaderId) == model->isMale(targetPerson)) {
 
                                 // 交换人员
                                 std::swap(local_groups[sourceGroup][leaderPos], local_groups[targetGroup][k]);
@@ -538,7 +579,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     for (int i = 0; i < local_groups.size(); i++) {
         int count = 0;
         for (int person : local_groups[i]) {
-            if (person != 0 && leaders.contains(id_to_name[person])) {
+            if (person != 0 && model->isLeader(person)) {
                 count++;
             }
         }
@@ -555,16 +596,17 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     }
 
     // 创建不可移动人员集合
-    QSet<int> immovable_people = fixed_people;
+    ArenaVector<char> immovable_people(fixed_people, arena.resource());
     for (int i = 0; i < local_groups.size(); i++) {
         for (int person : local_groups[i]) {
-            if (person != 0 && leaders.contains(id_to_name[person])) {
-                immovable_people.insert(person);
+            if (person != 0 && model->isLeader(person)) {
+                immovable_people[person] = 1;
             }
         }
     }
 
     // 男生连续在前，女生连续在后
+    profiler.begin("组内排列");
     logOutput->append("进行最终性别分组排列...");
 
     for (int i = 0; i < local_groups.size(); i++) {
@@ -572,7 +614,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
         QMap<int, int> fixed_positions_in_group;
         for (int j = 0; j < local_groups[i].size(); j++) {
             int person = local_groups[i][j];
-            if (person != 0 && fixed_people.contains(person)) {
+            if (person != 0 && fixed_people[person]) {
                 fixed_positions_in_group[j] = person;
             }
         }
@@ -584,7 +626,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
         for (int j = 0; j < local_groups[i].size(); j++) {
             int person = local_groups[i][j];
             if (person != 0 && !fixed_positions_in_group.contains(j)) {
-                if (getGender(person) == 'M') {
+                if (model->isMale(person)) {
                     non_fixed_males.append(person);
                 }
                 else {
@@ -642,7 +684,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
 
         for (int person : local_groups[i]) {
             if (person != 0) {
-                if (getGender(person) == 'M') {
+                if (model->isMale(person)) {
                     distribution += "M";
                     male_count++;
                     if (!in_male_section) {
@@ -666,10 +708,10 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
         bool male_after_female = false;
         for (int person : local_groups[i]) {
             if (person != 0) {
-                if (getGender(person) == 'F') {
+                if (!model->isMale(person)) {
                     found_female = true;
                 }
-                else if (getGender(person) == 'M' && found_female) {
+                else if (found_female) {
                     male_after_female = true;
                     break;
                 }
@@ -682,8 +724,9 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     }
 
     // 处理不能同组要求
+    profiler.begin("不能同组");
     logOutput->append("处理不能同组要求...");
-    QMap<int, int> person_to_group;
+    ArenaVector<int> person_to_group(personCount + 1, -1, arena.resource());
     for (int i = 0; i < local_groups.size(); i++) {
         for (int person : local_groups[i]) {
             if (person != 0) { // 跳过空位
@@ -692,13 +735,24 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
         }
     }
 
+    // 每组成员的位集合，用于快速判断目标组中是否已有同一要求的人
+    QVector<PersonBitset> groupMasks(local_groups.size(), model->emptyMask());
+    for (int i = 0; i < local_groups.size(); i++) {
+        for (int person : local_groups[i]) {
+            if (person != 0) groupMasks[i].set(person);
+        }
+    }
+
     bool changed = false;
     do {
         changed = false;
-        for (const auto& group : must_separate_groups) {
+        for (int setIdx = 0; setIdx < model->separateCount(); setIdx++) {
+            IdRange group = model->separateSet(setIdx);
+            const PersonBitset& separateMask = model->separateMask(setIdx);
             QMap<int, QVector<int>> group_members;
             for (int person : group) {
                 int g = person_to_group[person];
+                if (g < 0) continue;
                 group_members[g].append(person);
             }
 
@@ -713,7 +767,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
                     int current_group = person_to_group[person];
 
                     // 如果这个人在不可移动集合中，不能移动
-                    if (immovable_people.contains(person)) {
+                    if (immovable_people[person]) {
                         logOutput->append(QString("警告: 人员 %1 在不可移动位置，无法移动以满足不能同组要求").arg(id_to_name[person]));
                         continue;
                     }
@@ -730,20 +784,13 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
 
                     for (int target_group : candidate_groups) {
                         // 检查目标组中是否有当前要求组的其他人
-                        bool conflict = false;
-                        for (int p : group) {
-                            if (p != person && person_to_group[p] == target_group) {
-                                conflict = true;
-                                break;
-                            }
-                        }
-                        if (conflict) continue;
+                        if (groupMasks[target_group].intersects(separateMask)) continue;
 
                         // 在目标组找一个同性别的人交换
                         int x = findSameGenderInGroup(person, target_group, immovable_people);
                         if (x != -1) {
                             // 确保x不在当前要求组中且不是不可移动人员
-                            if (group.contains(x) || immovable_people.contains(x))
+                            if (x > personCount || group.contains(x) || immovable_people[x])
                                 continue;
 
                             // 交换
@@ -757,6 +804,10 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
                                 // 更新映射
                                 person_to_group[person] = target_group;
                                 person_to_group[x] = current_group;
+                                groupMasks[current_group].reset(person);
+                                groupMasks[current_group].set(x);
+                                groupMasks[target_group].reset(x);
+                                groupMasks[target_group].set(person);
 
                                 changed = true;
                                 moved = true;
@@ -771,12 +822,13 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     } while (changed);
 
     // 平衡外宿生分布
+    profiler.begin("外宿生");
     logOutput->append("平衡外宿生分布（不移动组长）...");
-    QMap<int, int> boarderCount;
+    ArenaVector<int> boarderCount(local_groups.size(), 0, arena.resource());
     for (int group_idx = 0; group_idx < local_groups.size(); group_idx++) {
         int count = 0;
         for (int person : local_groups[group_idx]) {
-            if (person != 0 && boarders.contains(id_to_name[person])) {
+            if (person != 0 && model->isBoarder(person)) {
                 count++;
             }
         }
@@ -814,13 +866,13 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
             bool moved = false;
             for (int i = 0; i < local_groups[maxGroup].size() && !moved; i++) {
                 int person = local_groups[maxGroup][i];
-                if (person != 0 && boarders.contains(id_to_name[person]) && !immovable_people.contains(person)) {
+                if (person != 0 && model->isBoarder(person) && !immovable_people[person]) {
                     // 在外宿生少的组找一个非外宿生交换
                     for (int j = 0; j < local_groups[minGroup].size() && !moved; j++) {
                         int otherPerson = local_groups[minGroup][j];
-                        if (otherPerson != 0 && !boarders.contains(id_to_name[otherPerson]) &&
-                            !immovable_people.contains(otherPerson) &&
-                            getGender(person) == getGender(otherPerson)) {
+                        if (otherPerson != 0 && !model->isBoarder(otherPerson) &&
+                            !immovable_people[otherPerson] &&
+                            model->isMale(person) == model->isMale(otherPerson)) {
                             // 交换
                             std::swap(local_groups[maxGroup][i], local_groups[minGroup][j]);
                             boarderCount[maxGroup]--;
@@ -841,31 +893,27 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     }
 
     // 使用交换算法优化固定位置
-    optimizeFixedPositions();
+    profiler.begin("固定位置优化");
+    optimizeFixedPositions(local_groups, *model);
 
     // 最终验证：检查固定位置和组长分配
+    profiler.begin("最终验证");
     logOutput->append("开始最终验证...");
 
     // 验证固定位置
-    for (auto it = fixedPositions.begin(); it != fixedPositions.end(); ++it) {
-        int personId = it.key();
-        FixedPosition fixedPos = it.value();
-        int groupNumber = fixedPos.groupNumber;
-        int seatPosition = fixedPos.seatPosition;
-        int groupIdx = groupNumber - 1;
-
-        int localIdx = enabledGroups.indexOf(groupIdx);
-        if (localIdx != -1) {
-            int seatIndex = seatPosition - 1;
-            if (local_groups[localIdx][seatIndex] == personId) {
-                logOutput->append(QString("✓ 固定位置验证通过: %1 在组%2座位%3")
-                    .arg(id_to_name[personId]).arg(groupNumber).arg(seatPosition));
-            }
-            else {
-                logOutput->append(QString("✗ 固定位置验证失败: %1 应该在组%2座位%3，实际在组%4")
-                    .arg(id_to_name[personId]).arg(groupNumber).arg(seatPosition)
-                    .arg(localIdx + 1));
-            }
+    for (int personId : fixedPersonIds) {
+        int localIdx = model->fixedGroup(personId);
+        int seatIndex = model->fixedSeat(personId);
+        if (localIdx == -1 || seatIndex < 0 || seatIndex >= local_groups[localIdx].size()) continue;
+        int groupNumber = model->groupNumber(localIdx);
+        if (local_groups[localIdx][seatIndex] == personId) {
+            logOutput->append(QString("✓ 固定位置验证通过: %1 在组%2座位%3")
+                .arg(id_to_name[personId]).arg(groupNumber).arg(seatIndex + 1));
+        }
+        else {
+            logOutput->append(QString("✗ 固定位置验证失败: %1 应该在组%2座位%3，实际在组%4")
+                .arg(id_to_name[personId]).arg(groupNumber).arg(seatIndex + 1)
+                .arg(localIdx + 1));
         }
     }
 
@@ -874,7 +922,7 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
     for (int i = 0; i < local_groups.size(); i++) {
         int leaderCount = 0;
         for (int person : local_groups[i]) {
-            if (person != 0 && leaders.contains(id_to_name[person])) {
+            if (person != 0 && model->isLeader(person)) {
                 leaderCount++;
             }
         }
@@ -902,146 +950,165 @@ QPair<QVector<QVector<int>>, QSet<int>> MainWindow::initializeGroupsWithConstrai
         local_groups[i] = nonZero;
     }
 
+    profiler.end();
     logOutput->append("分组完成");
+    logOutput->append("各阶段用时: " + profiler.summary());
+    if (AllocStats::enabled) {
+        for (const QString& line : profiler.details() + AllocStats::siteReport()) {
+            logOutput->append(line);
+        }
+    }
     return { local_groups, local_special_groups };
 }
 
 // 组内交换
 bool MainWindow::swapPersonsInGroup(int groupIndex, int seatA, int seatB)
 {
-    if (groupIndex < 0 || groupIndex >= groups.size()) return false;
-    if (seatA < 0 || seatA >= groups[groupIndex].size()) return false;
-    if (seatB < 0 || seatB >= groups[groupIndex].size()) return false;
-
-    std::swap(groups[groupIndex][seatA], groups[groupIndex][seatB]);
-    logOutput->append(QString("组内交换: 位置%1 ↔ 位置%2").arg(seatA + 1).arg(seatB + 1));
-    return true;
+    return applySwapBatch({ qMakePair(Position(groupIndex, seatA), Position(groupIndex, seatB)) }, false);
 }
 
 // 跨组交换
 bool MainWindow::swapPersonsBetweenGroups(int groupA, int seatA, int groupB, int seatB)
 {
-    if (groupA < 0 || groupA >= groups.size()) return false;
-    if (groupB < 0 || groupB >= groups.size()) return false;
-    if (seatA < 0 || seatA >= groups[groupA].size()) return false;
-    if (seatB < 0 || seatB >= groups[groupB].size()) return false;
-
-    // 检查性别要求
-    int personA = groups[groupA][seatA];
-    int personB = groups[groupB][seatB];
+    return applySwapBatch({ qMakePair(Position(groupA, seatA), Position(groupB, seatB)) }, false);
+}
 
-    if (getGender(personA) != getGender(personB)) {
-        logOutput->append("错误: 跨组交换需要同性别人员");
-        return false;
+// 在 state 上按顺序执行一串交换，逐条检查座位是否存在、跨组交换是否同性别。
+// 失败时 state 停在出错的那一步之前，只应对副本调用
+bool MainWindow::applySwapsTo(QVector<QVector<int>>& state, const QVector<QPair<Position, Position>>& swaps,
+    QString* error)
+{
+    auto validSeat = [&](const Position& position) {
+        return position.group >= 0 && position.group < state.size() &&
+            position.seat >= 0 && position.seat < state[position.group].size();
+        };
+
+    for (int i = 0; i < swaps.size(); i++) {
+        const Position& a = swaps[i].first;
+        const Position& b = swaps[i].second;
+        if (!validSeat(a) || !validSeat(b)) {
+            if (error) *error = QString("第%1步的座位不存在").arg(i + 1);
+            return false;
+        }
+        // 副本第一次写入时外层数组和被交换的两组才真正分离；外层先分离，组内数组的共享才看得出来
+        ALLOC_STATS_DETACH("applySwapsTo 分组副本", state);
+        state.detach();
+        ALLOC_STATS_DETACH("applySwapsTo 组内座位", std::as_const(state)[a.group]);
+        if (b.group != a.group) ALLOC_STATS_DETACH("applySwapsTo 组内座位", std::as_const(state)[b.group]);
+        int& personA = state[a.group][a.seat];
+        int& personB = state[b.group][b.seat];
+        if (a.group != b.group && getGender(personA) != getGender(personB)) {
+            if (error) *error = QString("第%1步跨组交换需要同性别人员").arg(i + 1);
+            return false;
+        }
+        std::swap(personA, personB);
     }
-
-    std::swap(groups[groupA][seatA], groups[groupB][seatB]);
-    logOutput->append(QString("跨组交换: 组%1位置%2 ↔ 组%3位置%4")
-        .arg(groupA + 1).arg(seatA + 1).arg(groupB + 1).arg(seatB + 1));
     return true;
 }
 
-// 移动人员到指定位置
-bool MainWindow::movePersonToPosition(int personId, int targetGroup, int targetSeat)
+// 批量交换：先在副本上检查并执行全部交换，有任何一步不合法时 groups 保持不变；
+// 全部合法时一次写回，手动调整步骤进行中时记入撤销历史，只输出一条日志。
+// refresh 为真时再刷新一次表格，并按新分组重新评估一次要求
+bool MainWindow::applySwapBatch(const QVector<QPair<Position, Position>>& swaps, bool refresh, QString* error)
 {
-    // 找到人员当前位置
-    int currentGroup = -1, currentSeat = -1;
-    for (int i = 0; i < groups.size(); i++) {
-        for (int j = 0; j < groups[i].size(); j++) {
-            if (groups[i][j] == personId) {
-                currentGroup = i;
-                currentSeat = j;
-                break;
-            }
-        }
-        if (currentGroup != -1) break;
-    }
-
-    if (currentGroup == -1) {
-        logOutput->append(QString("错误: 未找到人员 %1").arg(id_to_name[personId]));
+    QVector<QVector<int>> scratch = groups;
+    QString reason;
+    if (!applySwapsTo(scratch, swaps, &reason)) {
+        logOutput->append(QString("错误: %1，未做任何交换").arg(reason));
+        if (error) *error = reason;
         return false;
     }
+    if (swaps.isEmpty()) return true;
 
-    // 如果已经在目标位置，直接返回成功
-    if (currentGroup == targetGroup && currentSeat == targetSeat) {
-        return true;
-    }
-
-    // 查找交换路径
-    auto swapPath = findSwapPath(currentGroup, currentSeat, targetGroup, targetSeat);
-
-    if (swapPath.isEmpty()) {
-        logOutput->append(QString("错误: 无法找到从组%1位置%2到组%3位置%4的交换路径")
-            .arg(currentGroup + 1).arg(currentSeat + 1)
-            .arg(targetGroup + 1).arg(targetSeat + 1));
-        return false;
+    groups = scratch;
+    int crossGroup = 0;
+    for (const auto& swap : swaps) {
+        editHistory.record(swap.first.group, swap.first.seat, swap.second.group, swap.second.seat);
+        if (swap.first.group != swap.second.group) crossGroup++;
     }
 
-    // 执行交换链
-    for (const auto& swap : swapPath) {
-        if (swap.first.group == swap.second.group) {
-            // 组内交换
-            swapPersonsInGroup(swap.first.group, swap.first.seat, swap.second.seat);
+    if (swaps.size() == 1) {
+        const Position& a = swaps[0].first;
+        const Position& b = swaps[0].second;
+        if (crossGroup == 0) {
+            logOutput->append(QString("组内交换: 位置%1 ↔ 位置%2").arg(a.seat + 1).arg(b.seat + 1));
         }
         else {
-            // 跨组交换
-            swapPersonsBetweenGroups(swap.first.group, swap.first.seat,
-                swap.second.group, swap.second.seat);
+            logOutput->append(QString("跨组交换: 组%1位置%2 ↔ 组%3位置%4")
+                .arg(a.group + 1).arg(a.seat + 1).arg(b.group + 1).arg(b.seat + 1));
         }
     }
+    else {
+        logOutput->append(QString("批量交换: 共 %1 次（跨组 %2 次）").arg(swaps.size()).arg(crossGroup));
+    }
 
-    logOutput->append(QString("成功移动 %1 到组%2位置%3")
-        .arg(id_to_name[personId]).arg(targetGroup + 1).arg(targetSeat + 1));
+    if (refresh) {
+        printGroups();
+        prepareManualMove();
+        if (!examMode && manualModel->groupCount == groups.size()) {
+            updateStatus(QString("调整完成，当前违反代价 %1").arg(manualScore.total()));
+        }
+    }
     return true;
 }
 
-// 查找交换路径
-QVector<QPair<Position, Position>> MainWindow::findSwapPath(int startGroup, int startSeat, int targetGroup, int targetSeat)
+// 在 state 上查找把起点座位的人换到目标座位的交换路径
+// 广度优先搜索的状态只记录上一状态和最后一次交换，状态数组和访问标记分配在本次搜索的 arena 上
+QVector<QPair<Position, Position>> MainWindow::findSwapPath(const QVector<QVector<int>>& state, int startGroup, int startSeat, int targetGroup, int targetSeat)
 {
-    std::queue<SwapState> queue;
-    QSet<QString> visited;
+    SolverArena arena;
 
-    queue.push(SwapState(startGroup, startSeat, {}));
-    visited.insert(QString("%1-%2").arg(startGroup).arg(startSeat));
+    // 座位编号：组的起始偏移 + 组内座位号
+    ArenaVector<int> seatOffset(state.size() + 1, 0, arena.resource());
+    for (int i = 0; i < state.size(); i++) {
+        seatOffset[i + 1] = seatOffset[i] + state[i].size();
+    }
+    ArenaVector<char> visited(seatOffset.back(), 0, arena.resource());
+    ArenaVector<SwapState> states(arena.resource());
 
-    while (!queue.empty()) {
-        SwapState current = queue.front();
-        queue.pop();
+    states.push_back({ startGroup, startSeat, -1, {} });
+    visited[seatOffset[startGroup] + startSeat] = 1;
 
-        // 如果到达目标位置
+    for (int head = 0; head < int(states.size()); head++) {
+        SwapState current = states[head];
+
+        // 如果到达目标位置，沿 parent 回溯出交换路径
         if (current.group == targetGroup && current.seat == targetSeat) {
-            return current.path;
+            QVector<QPair<Position, Position>> path;
+            for (int k = head; states[k].parent >= 0; k = states[k].parent) {
+                path.append(states[k].swap);
+            }
+            std::reverse(path.begin(), path.end());
+            return path;
         }
 
         // 尝试所有可能的交换
 
         // 1. 同组交换
-        for (int otherSeat = 0; otherSeat < groups[current.group].size(); otherSeat++) {
+        for (int otherSeat = 0; otherSeat < state[current.group].size(); otherSeat++) {
             if (otherSeat != current.seat) {
-                QString newState = QString("%1-%2").arg(current.group).arg(otherSeat);
-                if (!visited.contains(newState)) {
-                    QVector<QPair<Position, Position>> newPath = current.path;
-                    newPath.append(qMakePair(Position(current.group, current.seat), Position(current.group, otherSeat)));
-                    queue.push(SwapState(current.group, otherSeat, newPath));
-                    visited.insert(newState);
+                char& seen = visited[seatOffset[current.group] + otherSeat];
+                if (!seen) {
+                    seen = 1;
+                    states.push_back({ current.group, otherSeat, head,
+                        qMakePair(Position(current.group, current.seat), Position(current.group, otherSeat)) });
                 }
             }
         }
 
         // 2. 跨组交换（只考虑同性别）
-        int currentPerson = groups[current.group][current.seat];
-        for (int otherGroup = 0; otherGroup < groups.size(); otherGroup++) {
+        int currentPerson = state[current.group][current.seat];
+        for (int otherGroup = 0; otherGroup < state.size(); otherGroup++) {
             if (otherGroup == current.group) continue;
 
-            for (int otherSeat = 0; otherSeat < groups[otherGroup].size(); otherSeat++) {
-                int otherPerson = groups[otherGroup][otherSeat];
+            for (int otherSeat = 0; otherSeat < state[otherGroup].size(); otherSeat++) {
+                int otherPerson = state[otherGroup][otherSeat];
                 if (getGender(currentPerson) == getGender(otherPerson)) {
-                    QString newState = QString("%1-%2").arg(otherGroup).arg(otherSeat);
-                    if (!visited.contains(newState)) {
-                        QVector<QPair<Position, Position>> newPath = current.path;
-                        newPath.append(qMakePair(Position(current.group, current.seat), Position(otherGroup, otherSeat)));
-                        queue.push(SwapState(otherGroup, otherSeat, newPath));
-                        visited.insert(newState);
+                    char& seen = visited[seatOffset[otherGroup] + otherSeat];
+                    if (!seen) {
+                        seen = 1;
+                        states.push_back({ otherGroup, otherSeat, head,
+                            qMakePair(Position(current.group, current.seat), Position(otherGroup, otherSeat)) });
                     }
                 }
             }
@@ -1052,41 +1119,38 @@ QVector<QPair<Position, Position>> MainWindow::findSwapPath(int startGroup, int
 }
 
 // 优化固定位置分配
-void MainWindow::optimizeFixedPositions()
+// state 为正在生成的分组（按启用组的本地下标），固定位置取自 model。
+// 各人的交换路径依次在副本上求出并检查执行，全部处理完后一次写回 state
+void MainWindow::optimizeFixedPositions(QVector<QVector<int>>& state, const ProblemModel& model)
 {
     logOutput->append("开始优化固定位置分配...");
 
     int successCount = 0;
     int failCount = 0;
-
-    // 构建当前分组的人员位置映射
-    QMap<int, QPair<int, int>> currentPositions;
-    for (int i = 0; i < groups.size(); i++) {
-        for (int j = 0; j < groups[i].size(); j++) {
-            if (groups[i][j] != 0) {
-                currentPositions[groups[i][j]] = qMakePair(i, j);
+    int swapCount = 0;
+    QVector<QVector<int>> scratch = state;
+
+    for (int personId = 1; personId <= model.personCount; personId++) {
+        if (!model.isFixed(personId)) continue;
+        int targetGroup = model.fixedGroup(personId);
+        int targetSeat = model.fixedSeat(personId);
+        if (targetGroup < 0 || targetSeat < 0) continue;
+
+        // 在副本中查找人员的当前位置（前面的交换可能已移动了他）
+        int currentGroup = -1, currentSeat = -1;
+        for (int i = 0; i < scratch.size() && currentGroup == -1; i++) {
+            int seat = scratch[i].indexOf(personId);
+            if (seat != -1) {
+                currentGroup = i;
+                currentSeat = seat;
             }
         }
-    }
-
-    for (auto it = fixedPositions.begin(); it != fixedPositions.end(); ++it) {
-        int personId = it.key();
-        FixedPosition fixedPos = it.value();
-        int targetGroup = fixedPos.groupNumber - 1;
-        int targetSeat = fixedPos.seatPosition - 1;
-
-        // 检查人员是否在当前分组中
-        if (!currentPositions.contains(personId)) {
+        if (currentGroup == -1) {
             logOutput->append(QString("错误: 人员 %1 不在当前分组中").arg(id_to_name[personId]));
             failCount++;
             continue;
         }
 
-        // 获取当前位置
-        QPair<int, int> currentPos = currentPositions[personId];
-        int currentGroup = currentPos.first;
-        int currentSeat = currentPos.second;
-
         // 如果已经在目标位置，直接返回成功
         if (currentGroup == targetGroup && currentSeat == targetSeat) {
             successCount++;
@@ -1094,17 +1158,159 @@ void MainWindow::optimizeFixedPositions()
         }
 
         // 尝试移动人员到固定位置
-        if (movePersonToPosition(personId, targetGroup, targetSeat)) {
+        auto swapPath = findSwapPath(scratch, currentGroup, currentSeat, targetGroup, targetSeat);
+        QVector<QVector<int>> attempt = scratch;
+        if (!swapPath.isEmpty() && applySwapsTo(attempt, swapPath)) {
+            scratch = attempt;
+            swapCount += swapPath.size();
             successCount++;
         }
         else {
             failCount++;
             logOutput->append(QString("固定位置分配失败: %1 到组%2位置%3")
-                .arg(id_to_name[personId]).arg(targetGroup + 1).arg(targetSeat + 1));
+                .arg(id_to_name[personId]).arg(model.groupNumber(targetGroup)).arg(targetSeat + 1));
+        }
+    }
+
+    state = scratch;
+    logOutput->append(QString("固定位置优化完成: 成功 %1, 失败 %2, 交换 %3 次")
+        .arg(successCount).arg(failCount).arg(swapCount));
+}
+
+// 当前名单、分组配置和要求条件
+ProblemInput MainWindow::problemInput()
+{
+    ProblemInput input;
+    input.maleCount = male_names.size();
+    input.femaleCount = female_names.size();
+    int personCount = input.maleCount + input.femaleCount;
+
+    for (const GroupConfig& config : groupConfigs) {
+        input.groupEnabled.append(config.enabled);
+        input.groupTotal.append(config.total);
+        input.groupMales.append(config.males);
+        input.groupFemales.append(config.females);
+    }
+
+    input.isLeader = QVector<bool>(personCount + 1, false);
+    input.isBoarder = QVector<bool>(personCount + 1, false);
+    for (int id = 1; id <= personCount; id++) {
+        QString name = id_to_name.value(id);
+        input.isLeader[id] = leaders.contains(name);
+        input.isBoarder[id] = boarders.contains(name);
+    }
+
+    for (auto it = fixedPositions.begin(); it != fixedPositions.end(); ++it) {
+        input.fixedSeats.insert(it.key(), qMakePair(it.value().groupNumber, it.value().seatPosition));
+    }
+
+    input.togetherSets = must_together_groups;
+    input.separateSets = must_separate_groups;
+
+    return input;
+}
+
+// 将当前名单、分组配置和要求条件编译为只读的问题模型
+// 编译结果缓存到输入改变为止，界面刷新和手动调整时反复取用不会重新编译
+std::shared_ptr<const ProblemModel> MainWindow::compileProblemModel()
+{
+    if (!problemModelCache) {
+        problemModelCache = ProblemModel::compile(problemInput());
+    }
+    return problemModelCache;
+}
+
+void MainWindow::invalidateProblemModel()
+{
+    problemModelCache.reset();
+}
+
+// 将模型编译时发现的要求矛盾写入日志，存在必然无法满足的矛盾时返回 false
+// 给出 relevant 时只报告并判断它选中的矛盾
+bool MainWindow::reportProblemConflicts(const ProblemModel& model,
+    const std::function<bool(const ProblemConflict&)>& relevant)
+{
+    auto clusterNames = [&](int c) {
+        QStringList names;
+        for (int person : model.cluster(c)) {
+            names.append(id_to_name.value(person));
+        }
+        return names.join("、");
+        };
+
+    bool feasible = true;
+    for (const ProblemConflict& conflict : model.conflicts()) {
+        if (relevant && !relevant(conflict)) continue;
+        if (conflict.fatal) feasible = false;
+        QString nameA = id_to_name.value(conflict.personA);
+        QString nameB = id_to_name.value(conflict.personB);
+        switch (conflict.type) {
+        case ProblemConflict::SeatShortage:
+            logOutput->append(QString("错误: 共 %1 人，但启用组的座位总数只有 %2 个")
+                .arg(conflict.value).arg(conflict.limit));
+            break;
+        case ProblemConflict::MaleQuota:
+            logOutput->append(QString("%1: 各组男生配额之和为 %2，与男生人数 %3 不符")
+                .arg(conflict.fatal ? "错误" : "警告").arg(conflict.value).arg(conflict.limit));
+            break;
+        case ProblemConflict::FemaleQuota:
+            logOutput->append(QString("%1: 各组女生配额之和为 %2，与女生人数 %3 不符")
+                .arg(conflict.fatal ? "错误" : "警告").arg(conflict.value).arg(conflict.limit));
+            break;
+        case ProblemConflict::GroupQuota:
+            logOutput->append(QString("错误: 组%1男女配额之和为 %2，超过该组座位数 %3")
+                .arg(model.groupNumber(conflict.group)).arg(conflict.value).arg(conflict.limit));
+            break;
+        case ProblemConflict::LeaderCount:
+            logOutput->append(QString("%1: 共 %2 名组长，启用了 %3 个组")
+                .arg(conflict.fatal ? "错误" : "警告").arg(conflict.value).arg(conflict.limit));
+            break;
+        case ProblemConflict::FixedGroupDisabled:
+            logOutput->append(QString("错误: %1 被固定在组%2，但该组未启用")
+                .arg(nameA).arg(conflict.value));
+            break;
+        case ProblemConflict::FixedSeatRange:
+            logOutput->append(QString("错误: %1 被固定在组%2座位%3，超出范围(1-%4)")
+                .arg(nameA).arg(model.groupNumber(conflict.group)).arg(conflict.value).arg(conflict.limit));
+            break;
+        case ProblemConflict::FixedSeatTaken:
+            logOutput->append(QString("错误: %1 和 %2 被固定在同一座位（组%3座位%4）")
+                .arg(nameA, nameB).arg(model.groupNumber(conflict.group)).arg(conflict.value));
+            break;
+        case ProblemConflict::SeparateTooLarge: {
+            QStringList names;
+            for (int person : model.separateSet(conflict.cluster)) {
+                names.append(id_to_name.value(person));
+            }
+            logOutput->append(QString("错误: 不能同组的 %1 共 %2 人，多于组数 %3")
+                .arg(names.join("、")).arg(conflict.value).arg(conflict.limit));
+            break;
+        }
+        case ProblemConflict::ClusterTooLarge:
+            logOutput->append(QString("错误: 必须同组的 %1 共 %2 人，超过所有组的座位数")
+                .arg(clusterNames(conflict.cluster)).arg(model.cluster(conflict.cluster).size()));
+            break;
+        case ProblemConflict::ClusterQuota:
+            logOutput->append(QString("警告: 必须同组的 %1 中有男生 %2 人、女生 %3 人，没有任何组的男女配额能容纳")
+                .arg(clusterNames(conflict.cluster)).arg(model.clusterMales(conflict.cluster))
+                .arg(model.cluster(conflict.cluster).size() - model.clusterMales(conflict.cluster)));
+            break;
+        case ProblemConflict::TogetherSeparate:
+            logOutput->append(QString("错误: %1 和 %2 既必须同组（%3）又不能同组")
+                .arg(nameA, nameB, clusterNames(conflict.cluster)));
+            break;
+        case ProblemConflict::FixedSplit:
+            logOutput->append(QString("错误: %1 和 %2 必须同组（%3），但被固定在不同的组")
+                .arg(nameA, nameB, clusterNames(conflict.cluster)));
+            break;
+        case ProblemConflict::FixedGroupTooSmall:
+            logOutput->append(QString("错误: %1 被固定在组%2，该组座位数不足以容纳必须同组的 %3")
+                .arg(nameA).arg(model.groupNumber(conflict.group)).arg(clusterNames(conflict.cluster)));
+            break;
         }
     }
 
-    logOutput->append(QString("固定位置优化完成: 成功 %1, 失败 %2").arg(successCount).arg(failCount));
+    return feasible;
 }
 
 void MainWindow::doExportSeatingPlan(const QString& fileName)
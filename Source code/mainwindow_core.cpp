@@ -29,6 +29,9 @@ void MainWindow::initNameMapping()
 
     QSettings settings(configPath, QSettings::IniFormat);
 
+    // 打开分组历史库（与配置文件同目录）
+    seatingHistory.open(QFileInfo(configPath).absolutePath() + "/seating_history.dat");
+
     // 从配置文件读取名单
     male_names = settings.value("Male/Names").toStringList();
     female_names = settings.value("Female/Names").toStringList();
@@ -58,6 +61,7 @@ void MainWindow::initNameMapping()
         name_to_id[female_names[i]] = i + male_names.size() + 1;
         id_to_name[i + male_names.size() + 1] = female_names[i];
     }
+    invalidateProblemModel();
 
     // 记录日志 - 添加空指针检查
     if (logOutput) {
@@ -78,12 +82,13 @@ void MainWindow::initGroupConfigs()
     groupConfigs.resize(10);
 
     // 默认配置 - 所有组使用相同的配置，但不强制人数
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < groupConfigs.size(); i++) {
         groupConfigs[i].enabled = (i < 9); // 默认启用前9组
         groupConfigs[i].total = (i < 9) ? 6 : 0; // 默认6人，但不再强制
         groupConfigs[i].males = -1; // -1表示不强制男生数量
         groupConfigs[i].females = -1; // -1表示不强制女生数量
     }
+    invalidateProblemModel();
 }
 
 void MainWindow::updateNameMapping()
@@ -102,6 +107,7 @@ void MainWindow::updateNameMapping()
         name_to_id[female_names[i]] = i + male_names.size() + 1;
         id_to_name[i + male_names.size() + 1] = female_names[i];
     }
+    invalidateProblemModel();
 
     // 记录日志
     logOutput->append(QString("更新了姓名映射: %1 名男生, %2 名女生").arg(male_names.size()).arg(female_names.size()));
@@ -112,7 +118,7 @@ void MainWindow::loadSettings()
     QSettings settings(configPath, QSettings::IniFormat);
 
     // 加载分组配置
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < groupConfigs.size(); i++) {
         settings.beginGroup(QString("GroupConfig_%1").arg(i));
         groupConfigs[i].enabled = settings.value("enabled", i < 9).toBool();
         groupConfigs[i].total = settings.value("total", i < 9 ? 6 : 0).toInt();
@@ -121,12 +127,6 @@ void MainWindow::loadSettings()
         settings.endGroup();
     }
 
-    // 计算实际启用的组数
-    actualGroupCount = 0;
-    for (int i = 0; i < 10; i++) {
-        if (groupConfigs[i].enabled) actualGroupCount++;
-    }
-
     // 加载固定位置 - 修改为新的格式
     fixedPositions.clear();
     QStringList fixedPositionsList = settings.value("FixedPositions/List").toStringList();
@@ -166,6 +166,42 @@ void MainWindow::loadSettings()
             must_separate_groups.append(group);
         }
     }
+
+    // 计算实际启用的组数
+    invalidateProblemModel();
+    actualGroupCount = compileProblemModel()->groupCount;
+
+    // 加载考场模式设置
+    examRows = settings.value("Exam/Rows", 30).toInt();
+    examCols = settings.value("Exam/Cols", 50).toInt();
+    examEightNeighbors = settings.value("Exam/EightNeighbors", false).toBool();
+    examAttributes.clear();
+    int examAttributeCount = settings.beginReadArray("ExamAttributes");
+    for (int i = 0; i < examAttributeCount; i++) {
+        settings.setArrayIndex(i);
+        QString name = settings.value("name").toString();
+        if (!name.isEmpty()) {
+            examAttributes[name] = settings.value("attribute").toString();
+        }
+    }
+    settings.endArray();
+    // 旧版本存为 "姓名,属性" 列表：按第一个逗号拆开，属性中的逗号保留
+    if (examAttributeCount == 0) {
+        QStringList examAttributeList = settings.value("Exam/Attributes").toStringList();
+        for (const QString& entry : examAttributeList) {
+            int comma = entry.indexOf(',');
+            if (comma > 0) {
+                examAttributes[entry.left(comma)] = entry.mid(comma + 1);
+            }
+        }
+    }
+
+    // 加载前排组号设置（用于历史查询）
+    frontGroupNumbers.clear();
+    QStringList frontGroupList = settings.value("History/FrontGroups", QStringList{ "1", "2", "3" }).toStringList();
+    for (const QString& entry : frontGroupList) {
+        frontGroupNumbers.insert(entry.toInt());
+    }
     updateConstraintTable();
 }
 
@@ -209,7 +245,7 @@ void MainWindow::saveSettings()
     QSettings settings(configPath, QSettings::IniFormat);
 
     // 保存分组配置
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < groupConfigs.size(); i++) {
         settings.beginGroup(QString("GroupConfig_%1").arg(i));
         settings.setValue("enabled", groupConfigs[i].enabled);
         settings.setValue("total", groupConfigs[i].total);
@@ -248,11 +284,35 @@ void MainWindow::saveSettings()
     }
     settings.setValue("Constraints/MustSeparate", mustSeparateList);
 
+    // 保存考场模式设置
+    settings.setValue("Exam/Rows", examRows);
+    settings.setValue("Exam/Cols", examCols);
+    settings.setValue("Exam/EightNeighbors", examEightNeighbors);
+    // 姓名和属性分开存放，属性里可以有逗号
+    settings.remove("Exam/Attributes");
+    settings.remove("ExamAttributes");
+    settings.beginWriteArray("ExamAttributes", examAttributes.size());
+    int examAttributeIndex = 0;
+    for (auto it = examAttributes.begin(); it != examAttributes.end(); ++it) {
+        settings.setArrayIndex(examAttributeIndex++);
+        settings.setValue("name", it.key());
+        settings.setValue("attribute", it.value());
+    }
+    settings.endArray();
+
+    // 保存前排组号设置
+    QStringList frontGroupList;
+    for (int groupNumber : frontGroupNumbers) {
+        frontGroupList.append(QString::number(groupNumber));
+    }
+    settings.setValue("History/FrontGroups", frontGroupList);
+
     settings.sync();
 }
 
 void MainWindow::addConstraint()
 {
+    abortBackgroundSolve();
     // 添加输入验证
     QString names = nameInput->text().trimmed();
     if (names.contains(",") || names.contains(";")) {
@@ -297,6 +357,7 @@ void MainWindow::addConstraint()
     else {
         must_separate_groups.append(ids);
     }
+    invalidateProblemModel();
 
     // 更新要求表格
     int row = constraintTable->rowCount();
@@ -312,10 +373,46 @@ void MainWindow::addConstraint()
 
     nameInput->clear();
     updateStatus("要求添加成功");
+
+    // 立即检查新要求是否与已有要求矛盾：只报告涉及这条要求的人员或其同组集合的矛盾
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    QSet<int> added(ids.begin(), ids.end());
+    int separateIndex = must_separate_groups.size() - 1;
+    auto involvesAdded = [&](IdRange people) {
+        for (int person : people) {
+            if (added.contains(person)) return true;
+        }
+        return false;
+        };
+    auto relevant = [&](const ProblemConflict& conflict) {
+        switch (conflict.type) {
+        case ProblemConflict::SeparateTooLarge:
+            return typeStr == "S" && conflict.cluster == separateIndex;
+        case ProblemConflict::TogetherSeparate:
+            return typeStr == "T" ? involvesAdded(model->cluster(conflict.cluster))
+                : added.contains(conflict.personA) && added.contains(conflict.personB);
+        case ProblemConflict::ClusterTooLarge:
+        case ProblemConflict::ClusterQuota:
+        case ProblemConflict::FixedSplit:
+        case ProblemConflict::FixedGroupTooSmall:
+            return typeStr == "T" && involvesAdded(model->cluster(conflict.cluster));
+        default:
+            return false;
+        }
+        };
+    if (!reportProblemConflicts(*model, relevant)) {
+        constraintTable->item(row, 2)->setText("存在矛盾");
+    }
+
+    // 已有分组时提示可在现有座位上调整
+    if (!groups.isEmpty() && !examMode) {
+        logOutput->append("提示: 可点击\"最小变动调整\"在当前分组上满足新要求");
+    }
 }
 
 void MainWindow::removeConstraint()
 {
+    abortBackgroundSolve();
     QModelIndexList selected = constraintTable->selectionModel()->selectedRows();
     if (selected.isEmpty()) {
         QMessageBox::information(this, "提示", "请先选择要移除的要求");
@@ -343,11 +440,13 @@ void MainWindow::removeConstraint()
         }
         constraintTable->removeRow(row);
     }
+    invalidateProblemModel();
     updateStatus("要求已移除");
 }
 
 void MainWindow::generateGroups()
 {
+    abortBackgroundSolve();
     try {
         // 显示进度对话框
         QProgressDialog progress("正在生成分组...", "取消", 0, 0, this);
@@ -361,6 +460,21 @@ void MainWindow::generateGroups()
         // 调用分组算法
         auto result = initializeGroupsWithConstraints();
         groups = result.first;
+        examMode = false;
+
+        // 贪心结果仍有违反项时，在后台用多种策略并行改进，表格逐步显示当前最好结果，
+        // 结束（或点击"停止优化"）后再记入历史
+        if (!groups.isEmpty() && startBackgroundSolve(5000)) {
+            printGroups();
+            progress.close();
+            updateStatus("正在后台优化分组，可随时点击\"停止优化\"保留当前结果");
+            return;
+        }
+
+        // 记录到分组历史
+        if (!groups.isEmpty()) {
+            recordSeatingHistory("生成分组", lastSeed);
+        }
 
         // 更新分组表格
         printGroups();
@@ -403,6 +517,9 @@ void MainWindow::checkPersonnel()
         int boarderCount = 0;
 
         for (int person : groups[i]) {
+            // 考场模式下的空座
+            if (person == 0) continue;
+
             QString name = id_to_name[person];
             if (getGender(person) == 'M') maleCount++;
             else femaleCount++;
@@ -461,17 +578,29 @@ void MainWindow::checkPersonnel()
 
 void MainWindow::checkConstraints()
 {
+    if (examMode) {
+        int conflicts = countExamConflicts();
+        logOutput->append(conflicts == 0 ? QString("考场座位检查: 无同属性相邻")
+            : QString("考场座位检查: 有 %1 对同属性考生相邻").arg(conflicts));
+        updateStatus("要求检查完成");
+        return;
+    }
+
     showConstraintViolations();
     updateStatus("要求检查完成");
 }
 
 void MainWindow::resetAll()
 {
+    abortBackgroundSolve();
     groups.clear();
+    examMode = false;
     must_together_groups.clear();
     must_separate_groups.clear();
+    invalidateProblemModel();
     constraintTable->setRowCount(0);
-    groupTable->setRowCount(0);
+    groupModel->clear();
+    seatMap->setGroups({}, {});
     logOutput->clear();
     updateStatus("系统已重置");
 }
@@ -494,17 +623,30 @@ void MainWindow::showConstraintViolations()
     // 构建人-组映射
     QMap<int, int> person_to_group = buildPersonToGroup();
 
+    // 每组成员的位集合，要求在某组的人数 = 按位与后的popcount
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    QVector<PersonBitset> groupMasks(groups.size(), model->emptyMask());
+    for (int i = 0; i < groups.size(); i++) {
+        for (int person : groups[i]) {
+            if (person >= 1 && person <= model->personCount) groupMasks[i].set(person);
+        }
+    }
+
     bool constraints_satisfied = true;
 
-    // 检查必须同组要求
-    for (const auto& group : must_together_groups) {
-        QSet<int> group_set;
-        for (int person : group) {
-            group_set.insert(person_to_group[person]);
+    // 检查必须同组要求：某一组包含该要求的全部成员
+    for (int s = 0; s < model->togetherCount(); s++) {
+        int size = model->togetherMask(s).count();
+        bool together = false;
+        for (const PersonBitset& members : groupMasks) {
+            if (members.countAnd(model->togetherMask(s)) == size) {
+                together = true;
+                break;
+            }
         }
-        if (group_set.size() != 1) {
+        if (!together) {
             QString msg = "必须同组要求未满足: ";
-            for (int person : group) {
+            for (int person : must_together_groups[s]) {
                 msg += id_to_name[person] + " ";
             }
             logOutput->append(msg);
@@ -525,15 +667,12 @@ void MainWindow::showConstraintViolations()
         }
     }
 
-    // 检查不能同组要求
-    for (const auto& group : must_separate_groups) {
-        QMap<int, int> group_count;
-        for (int person : group) {
-            int g = person_to_group[person];
-            group_count[g]++;
-            if (group_count[g] > 1) {
+    // 检查不能同组要求：任何一组中该要求的人数都不超过1
+    for (int s = 0; s < model->separateCount(); s++) {
+        for (const PersonBitset& members : groupMasks) {
+            if (members.countAnd(model->separateMask(s)) > 1) {
                 QString msg = "不能同组要求未满足: ";
-                for (int person : group) {
+                for (int person : must_separate_groups[s]) {
                     msg += id_to_name[person] + " ";
                 }
                 logOutput->append(msg);
@@ -543,6 +682,27 @@ void MainWindow::showConstraintViolations()
         }
     }
 
+    // 检查组长和外宿生分布：每组最多一个组长（组长够分时每组都要有），各组外宿生人数相差不超过1
+    int minBoarders = INT_MAX, maxBoarders = 0;
+    for (int i = 0; i < groupMasks.size(); i++) {
+        int leaders = groupMasks[i].countAnd(model->leaderMask());
+        if (leaders > 1) {
+            logOutput->append(QString("组%1 有%2个组长").arg(i + 1).arg(leaders));
+            constraints_satisfied = false;
+        }
+        else if (leaders == 0 && model->leaderMask().count() >= groupMasks.size()) {
+            logOutput->append(QString("组%1 没有组长").arg(i + 1));
+            constraints_satisfied = false;
+        }
+        int boarders = groupMasks[i].countAnd(model->boarderMask());
+        minBoarders = qMin(minBoarders, boarders);
+        maxBoarders = qMax(maxBoarders, boarders);
+    }
+    if (!groupMasks.isEmpty() && maxBoarders - minBoarders > 1) {
+        logOutput->append(QString("外宿生分布不均: 各组外宿生人数在 %1 到 %2 之间").arg(minBoarders).arg(maxBoarders));
+        constraints_satisfied = false;
+    }
+
     if (constraints_satisfied) {
         logOutput->append("所有要求已满足");
     }
@@ -569,7 +729,8 @@ void MainWindow::swapPersons(int a, int b)
 }
 
 // 现有的函数
-int MainWindow::findSameGenderInGroup(int person, int target_group_idx, const QSet<int>& fixed_people)
+// fixed_people 按人员ID标记不可交换的人，长度可以小于人数（未覆盖的视为可交换）
+int MainWindow::findSameGenderInGroup(int person, int target_group_idx, const ArenaVector<char>& fixed_people)
 {
     QChar gender = getGender(person);
     QVector<int> candidates;
@@ -581,7 +742,7 @@ int MainWindow::findSameGenderInGroup(int person, int target_group_idx, const QS
 
     for (int p : groups[target_group_idx]) {
         // 跳过空位和固定位置人员
-        if (p == 0 || fixed_people.contains(p)) continue;
+        if (p == 0 || (p < int(fixed_people.size()) && fixed_people[p])) continue;
 
         if (getGender(p) == gender) {
             candidates.append(p);
@@ -590,18 +751,20 @@ int MainWindow::findSameGenderInGroup(int person, int target_group_idx, const QS
 
     if (candidates.isEmpty()) return -1;
 
-    // 使用随机数生成器选择候选者
-    std::random_device rd;
-    std::mt19937 g(rd());
+    // 从本次生成的专用随机数流中接着上次的位置取数
+    CounterRng g(lastSeed, 0, RngPhase::SameGenderPick);
+    g.seek(sameGenderDraws);
     std::uniform_int_distribution<int> dist(0, candidates.size() - 1);
-    return candidates[dist(g)];
+    int picked = candidates[dist(g)];
+    sameGenderDraws = g.position();
+    return picked;
 }
 
 // 添加缺少的函数（两个参数版本）
 int MainWindow::findSameGenderInGroup(int person, int target_group_idx)
 {
     // 调用三个参数的版本，传入空的 fixed_people 集合
-    return findSameGenderInGroup(person, target_group_idx, QSet<int>());
+    return findSameGenderInGroup(person, target_group_idx, ArenaVector<char>());
 }
 
 // 添加固定位置
@@ -612,8 +775,10 @@ void MainWindow::addFixedPosition() {
 
 // 清空固定位置
 void MainWindow::clearFixedPositions() {
+    abortBackgroundSolve();
     if (QMessageBox::question(this, "确认", "确定要清空所有固定位置吗?") == QMessageBox::Yes) {
         fixedPositions.clear();
+        invalidateProblemModel();
         updateFixedPositionTable();
         updateStatus("已清空所有固定位置");
     }
@@ -628,6 +793,10 @@ void MainWindow::someFunction() {
 
 MainWindow::~MainWindow()
 {
+    if (solveRunning()) {
+        solveCancel->cancel();
+        solveThread.join();
+    }
     saveSettings();
 
 #ifdef Q_OS_WIN
@@ -641,37 +810,29 @@ MainWindow::~MainWindow()
 
 GroupConfig MainWindow::getGroupConfigForIndex(int index)
 {
-    int enabledCount = -1;
-    for (int i = 0; i < 10; i++) {
-        if (groupConfigs[i].enabled) {
-            enabledCount++;
-            if (enabledCount == index) {
-                return groupConfigs[i];
-            }
-        }
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    if (index < 0 || index >= model->groupCount) {
+        return GroupConfig{ false, 0, 0, 0 };
     }
-    return GroupConfig{ false, 0, 0, 0 };
+    return groupConfigs[model->enabledGroups[index]];
 }
 
 void MainWindow::newFile()
 {
+    abortBackgroundSolve();
     // 清空分组数据但保留要求条件
     groups.clear();
 
     // 初始化空分组
     groups.resize(GROUP_COUNT);
 
-    // 清空分组表格
-    groupTable->setRowCount(0);
-
     // 初始化空分组表格
-    groupTable->setRowCount(GROUP_COUNT);
+    QStringList rowLabels;
     for (int i = 0; i < GROUP_COUNT; i++) {
-        groupTable->setItem(i, 0, new QTableWidgetItem(QString("组 %1").arg(i + 1)));
-        for (int j = 1; j <= MAX_GROUP_SIZE; j++) {
-            groupTable->setItem(i, j, new QTableWidgetItem(""));
-        }
+        rowLabels << QString("组 %1").arg(i + 1);
     }
+    groupModel->setAssignment(rowLabels, "组号", "成员", MAX_GROUP_SIZE, groups);
+    seatMap->setGroups(rowLabels, groups);
 
     // 询问用户保存位置
     QString defaultFileName = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + "_空座位表.xlsx";
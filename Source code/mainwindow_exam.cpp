@@ -0,0 +1,337 @@
+#include "mainwindow.h"
+#include <QHeaderView>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// 计算某个座位与邻座同属性的冲突数
+int examSeatConflicts(const QVector<int>& seatClass, int rows, int cols, bool eightNeighbors, int seat)
+{
+    int cls = seatClass[seat];
+    if (cls < 0) return 0;
+
+    int r = seat / cols;
+    int c = seat % cols;
+    int conflicts = 0;
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int dc = -1; dc <= 1; dc++) {
+            if (dr == 0 && dc == 0) continue;
+            if (!eightNeighbors && dr != 0 && dc != 0) continue;
+            int nr = r + dr;
+            int nc = c + dc;
+            if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+            if (seatClass[nr * cols + nc] == cls) conflicts++;
+        }
+    }
+    return conflicts;
+}
+
+} // namespace
+
+// 考场座位求解：先按着色模式铺位，再局部修复剩余冲突
+// studentClass[i] 为第 i 名考生的属性编号，-1 表示无属性（不参与相邻检查）
+// 返回每个座位上的考生下标，-1 表示空座
+QVector<int> MainWindow::solveExamSeating(const QVector<int>& studentClass, int rows, int cols, bool eightNeighbors)
+{
+    const int seatCount = rows * cols;
+    QVector<int> seatStudent(seatCount, -1);
+    if (studentClass.size() > seatCount) {
+        return seatStudent;
+    }
+
+    std::random_device rd;
+    std::mt19937 g(rd());
+
+    // 按属性分桶，人数多的属性优先占用同色座位
+    QMap<int, QVector<int>> buckets;
+    QVector<int> unclassified;
+    for (int i = 0; i < studentClass.size(); i++) {
+        if (studentClass[i] < 0) {
+            unclassified.append(i);
+        }
+        else {
+            buckets[studentClass[i]].append(i);
+        }
+    }
+
+    QVector<QVector<int>> orderedBuckets;
+    for (auto it = buckets.begin(); it != buckets.end(); ++it) {
+        QVector<int> members = it.value();
+        std::shuffle(members.begin(), members.end(), g);
+        orderedBuckets.append(members);
+    }
+    std::stable_sort(orderedBuckets.begin(), orderedBuckets.end(), [](const QVector<int>& a, const QVector<int>& b) {
+        return a.size() > b.size();
+        });
+    std::shuffle(unclassified.begin(), unclassified.end(), g);
+
+    // 着色：4邻域用棋盘两色，8邻域用2x2四色，同色座位互不相邻
+    int colorCount = eightNeighbors ? 4 : 2;
+    QVector<QVector<int>> colorSeats(colorCount);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int color = eightNeighbors ? ((r & 1) * 2 + (c & 1)) : ((r + c) & 1);
+            colorSeats[color].append(r * cols + c);
+        }
+    }
+
+    // 按颜色顺序铺位：同一属性尽量落在同一颜色类中
+    QVector<int> seatOrder;
+    seatOrder.reserve(seatCount);
+    for (const auto& seats : colorSeats) {
+        seatOrder += seats;
+    }
+
+    int cursor = 0;
+    for (const auto& members : orderedBuckets) {
+        for (int student : members) {
+            seatStudent[seatOrder[cursor++]] = student;
+        }
+    }
+    // 无属性的考生放在最后，正好可以隔开跨颜色类的属性
+    for (int student : unclassified) {
+        seatStudent[seatOrder[cursor++]] = student;
+    }
+
+    // 局部修复：对冲突座位尝试交换，直到无冲突或达到上限
+    QVector<int> seatClass(seatCount, -1);
+    for (int s = 0; s < seatCount; s++) {
+        if (seatStudent[s] >= 0) seatClass[s] = studentClass[seatStudent[s]];
+    }
+
+    std::uniform_int_distribution<int> seatDist(0, seatCount - 1);
+    const int maxRounds = 200;
+    const int samplesPerSeat = 64;
+    const qint64 repairBudgetMs = 300;
+
+    QElapsedTimer repairTimer;
+    repairTimer.start();
+
+    for (int round = 0; round < maxRounds && repairTimer.elapsed() < repairBudgetMs; round++) {
+        QVector<int> conflicted;
+        for (int s = 0; s < seatCount; s++) {
+            if (examSeatConflicts(seatClass, rows, cols, eightNeighbors, s) > 0) {
+                conflicted.append(s);
+            }
+        }
+        if (conflicted.isEmpty()) break;
+
+        std::shuffle(conflicted.begin(), conflicted.end(), g);
+        bool improved = false;
+
+        for (int s : conflicted) {
+            int before_s = examSeatConflicts(seatClass, rows, cols, eightNeighbors, s);
+            if (before_s == 0) continue;
+
+            int bestTarget = -1;
+            int bestDelta = 0;
+            for (int k = 0; k < samplesPerSeat; k++) {
+                int t = seatDist(g);
+                if (t == s || seatClass[t] == seatClass[s]) continue;
+
+                int before = before_s + examSeatConflicts(seatClass, rows, cols, eightNeighbors, t);
+                std::swap(seatClass[s], seatClass[t]);
+                int after = examSeatConflicts(seatClass, rows, cols, eightNeighbors, s) +
+                    examSeatConflicts(seatClass, rows, cols, eightNeighbors, t);
+                std::swap(seatClass[s], seatClass[t]);
+
+                if (after - before < bestDelta) {
+                    bestDelta = after - before;
+                    bestTarget = t;
+                }
+            }
+
+            if (bestTarget != -1) {
+                std::swap(seatClass[s], seatClass[bestTarget]);
+                std::swap(seatStudent[s], seatStudent[bestTarget]);
+                improved = true;
+            }
+        }
+
+        if (!improved) break;
+    }
+
+    return seatStudent;
+}
+
+// 统计考场中同属性相邻的对数
+int MainWindow::countExamConflicts()
+{
+    if (!examMode || groups.isEmpty()) return 0;
+
+    int rows = groups.size();
+    int cols = groups[0].size();
+    QVector<int> seatClass(rows * cols, -1);
+    QMap<QString, int> classIds;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols && c < groups[r].size(); c++) {
+            int person = groups[r][c];
+            if (person == 0) continue;
+            QString attr = examAttributes.value(id_to_name.value(person));
+            if (attr.isEmpty()) continue;
+            if (!classIds.contains(attr)) classIds.insert(attr, classIds.size());
+            seatClass[r * cols + c] = classIds.value(attr);
+        }
+    }
+
+    int total = 0;
+    for (int s = 0; s < seatClass.size(); s++) {
+        total += examSeatConflicts(seatClass, rows, cols, examEightNeighbors, s);
+    }
+    return total / 2;
+}
+
+void MainWindow::generateExamSeating()
+{
+    abortBackgroundSolve();
+    int studentCount = male_names.size() + female_names.size();
+    int seatCount = examRows * examCols;
+
+    if (studentCount == 0) {
+        QMessageBox::warning(this, "错误", "名单为空，请先在设置中填写人员名单");
+        return;
+    }
+    if (studentCount > seatCount) {
+        QMessageBox::warning(this, "错误", QString("考场座位不足: %1 个座位，%2 名考生").arg(seatCount).arg(studentCount));
+        return;
+    }
+
+    // 属性字符串映射为编号，下标与人员ID对应（ID从1开始）
+    QMap<QString, int> classIds;
+    QVector<int> studentClass(studentCount, -1);
+    for (int id = 1; id <= studentCount; id++) {
+        QString attr = examAttributes.value(id_to_name.value(id));
+        if (attr.isEmpty()) continue;
+        if (!classIds.contains(attr)) classIds.insert(attr, classIds.size());
+        studentClass[id - 1] = classIds.value(attr);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<int> seatStudent = solveExamSeating(studentClass, examRows, examCols, examEightNeighbors);
+
+    // 每一排作为一行写入 groups，空座为 0，沿用现有的导出流程（组号-位置 即 排号-座位）
+    groups.clear();
+    groups.resize(examRows);
+    for (int r = 0; r < examRows; r++) {
+        groups[r] = QVector<int>(examCols, 0);
+        for (int c = 0; c < examCols; c++) {
+            int student = seatStudent[r * examCols + c];
+            if (student >= 0) groups[r][c] = student + 1;
+        }
+    }
+    examMode = true;
+
+    qint64 elapsed = timer.elapsed();
+    printGroups();
+
+    int conflicts = countExamConflicts();
+    logOutput->append(QString("考场排座完成: %1排 x %2列, %3 名考生, %4 种属性, %5邻域, 用时 %6 ms")
+        .arg(examRows).arg(examCols).arg(studentCount).arg(classIds.size())
+        .arg(examEightNeighbors ? 8 : 4).arg(elapsed));
+    if (conflicts > 0) {
+        logOutput->append(QString("警告: 仍有 %1 对同属性考生相邻，请增加座位或减少相邻限制").arg(conflicts));
+    }
+    updateStatus("考场座位生成完成");
+}
+
+void MainWindow::printExamGrid()
+{
+    int rows = groups.size();
+    int cols = rows > 0 ? groups[0].size() : 0;
+
+    QStringList rowLabels;
+    for (int r = 0; r < rows; r++) {
+        rowLabels << QString("第%1排").arg(r + 1);
+    }
+
+    groupModel->setPeople(personDisplays(true));
+    groupModel->setAssignment(rowLabels, "排号", "座位", cols, groups);
+    seatMap->setPeople(personDisplays(true));
+    seatMap->setExamGrid(groups);
+}
+
+void MainWindow::showExamDialog()
+{
+    abortBackgroundSolve();
+    QDialog dialog(this);
+    dialog.setWindowTitle("考场模式");
+    dialog.resize(450, 500);
+
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+
+    // 考场尺寸与邻域设置
+    QGridLayout* hallLayout = new QGridLayout();
+    hallLayout->addWidget(new QLabel("排数:"), 0, 0);
+    QSpinBox* rowSpin = new QSpinBox(&dialog);
+    rowSpin->setRange(1, 200);
+    rowSpin->setValue(examRows);
+    hallLayout->addWidget(rowSpin, 0, 1);
+
+    hallLayout->addWidget(new QLabel("每排座位数:"), 1, 0);
+    QSpinBox* colSpin = new QSpinBox(&dialog);
+    colSpin->setRange(1, 200);
+    colSpin->setValue(examCols);
+    hallLayout->addWidget(colSpin, 1, 1);
+
+    hallLayout->addWidget(new QLabel("相邻判定:"), 2, 0);
+    QComboBox* neighborCombo = new QComboBox(&dialog);
+    neighborCombo->addItem("前后左右 (4邻域)", false);
+    neighborCombo->addItem("含斜对角 (8邻域)", true);
+    neighborCombo->setCurrentIndex(examEightNeighbors ? 1 : 0);
+    hallLayout->addWidget(neighborCombo, 2, 1);
+    layout->addLayout(hallLayout);
+
+    // 考生属性（班级或科目）
+    QLabel* attrLabel = new QLabel("考生属性 (每行: 姓名 班级/科目，同属性不相邻):");
+    layout->addWidget(attrLabel);
+    QTextEdit* attrEdit = new QTextEdit(&dialog);
+    QStringList attrLines;
+    for (auto it = examAttributes.begin(); it != examAttributes.end(); ++it) {
+        attrLines.append(it.key() + " " + it.value());
+    }
+    attrEdit->setPlainText(attrLines.join("\n"));
+    layout->addWidget(attrEdit);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    QPushButton* generateExamBtn = new QPushButton("生成考场座位");
+    QPushButton* cancelButton = new QPushButton("取消");
+    buttonLayout->addWidget(generateExamBtn);
+    buttonLayout->addWidget(cancelButton);
+    layout->addLayout(buttonLayout);
+
+    connect(generateExamBtn, &QPushButton::clicked, [&]() {
+        QMap<QString, QString> attributes;
+        QStringList invalidNames;
+        for (const QString& line : attrEdit->toPlainText().split("\n", Qt::SkipEmptyParts)) {
+            QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+            if (parts.size() < 2) continue;
+            if (!name_to_id.contains(parts[0])) {
+                invalidNames.append(parts[0]);
+                continue;
+            }
+            attributes[parts[0]] = parts[1];
+        }
+
+        if (!invalidNames.isEmpty()) {
+            QMessageBox::warning(&dialog, "输入错误", "以下姓名不在名单中: " + invalidNames.join(", "));
+            return;
+        }
+
+        examRows = rowSpin->value();
+        examCols = colSpin->value();
+        examEightNeighbors = neighborCombo->currentData().toBool();
+        examAttributes = attributes;
+        saveSettings();
+
+        dialog.accept();
+        generateExamSeating();
+        });
+
+    connect(cancelButton, &QPushButton::clicked, &dialog, &QDialog::reject);
+
+    dialog.exec();
+}
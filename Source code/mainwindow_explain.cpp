@@ -0,0 +1,138 @@
+#include "mainwindow.h"
+#include <QElapsedTimer>
+#include <functional>
+
+namespace {
+
+// 参与解释的一条要求
+struct ExplainItem {
+    enum Kind { Together, Separate, Fixed };
+    Kind kind;
+    int index;      // 必须同组/不能同组要求的下标，固定位置为人员ID
+};
+
+// QuickXplain：在背景条件 background 下，从 candidates 中找出一个极小的矛盾子集
+// 去掉结果中任意一条后其余要求即可同时满足
+class QuickXplain {
+public:
+    explicit QuickXplain(std::function<bool(const QVector<ExplainItem>&)> check)
+        : consistent(std::move(check)) {}
+
+    QVector<ExplainItem> run(const QVector<ExplainItem>& candidates)
+    {
+        if (candidates.isEmpty() || check(candidates)) return {};
+        if (!check({})) return {};
+        return explain({}, false, candidates);
+    }
+
+    int checks = 0;
+
+private:
+    QVector<ExplainItem> explain(const QVector<ExplainItem>& background, bool deltaNonEmpty,
+        const QVector<ExplainItem>& candidates)
+    {
+        if (deltaNonEmpty && !check(background)) return {};
+        if (candidates.size() == 1) return candidates;
+
+        int half = candidates.size() / 2;
+        QVector<ExplainItem> first = candidates.mid(0, half);
+        QVector<ExplainItem> second = candidates.mid(half);
+
+        QVector<ExplainItem> withFirst = background + first;
+        QVector<ExplainItem> delta2 = explain(withFirst, !first.isEmpty(), second);
+        QVector<ExplainItem> withDelta2 = background + delta2;
+        QVector<ExplainItem> delta1 = explain(withDelta2, !delta2.isEmpty(), first);
+        return delta1 + delta2;
+    }
+
+    bool check(const QVector<ExplainItem>& items)
+    {
+        checks++;
+        return consistent(items);
+    }
+
+    std::function<bool(const QVector<ExplainItem>&)> consistent;
+};
+
+} // namespace
+
+// 分组失败后找出互相矛盾的最少几条要求（必须同组、不能同组、固定位置）并写入日志
+// 只检查硬性要求：座位数作为背景条件，配额、组长等不参与；找到矛盾时返回 true
+bool MainWindow::explainConflicts()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 背景条件：名单和各组座位数，不含配额和组长
+    ProblemInput base = problemInput();
+    base.groupMales.fill(-1);
+    base.groupFemales.fill(-1);
+    base.isLeader.fill(false);
+    base.togetherSets.clear();
+    base.separateSets.clear();
+    base.fixedSeats.clear();
+
+    QVector<ExplainItem> candidates;
+    for (int i = 0; i < must_together_groups.size(); i++) {
+        candidates.append({ ExplainItem::Together, i });
+    }
+    for (int i = 0; i < must_separate_groups.size(); i++) {
+        candidates.append({ ExplainItem::Separate, i });
+    }
+    for (auto it = fixedPositions.begin(); it != fixedPositions.end(); ++it) {
+        candidates.append({ ExplainItem::Fixed, it.key() });
+    }
+
+    QuickXplain xplain([&](const QVector<ExplainItem>& items) {
+        ProblemInput input = base;
+        for (const ExplainItem& item : items) {
+            if (item.kind == ExplainItem::Together) {
+                input.togetherSets.append(must_together_groups[item.index]);
+            }
+            else if (item.kind == ExplainItem::Separate) {
+                input.separateSets.append(must_separate_groups[item.index]);
+            }
+            else {
+                const FixedPosition& pos = fixedPositions[item.index];
+                input.fixedSeats.insert(item.index, qMakePair(pos.groupNumber, pos.seatPosition));
+            }
+        }
+        std::shared_ptr<const ProblemModel> model = ProblemModel::compile(input);
+        return ExactSolver(*model).solve(20000) != ExactSolver::Infeasible;
+        });
+
+    QVector<ExplainItem> conflict = xplain.run(candidates);
+    if (conflict.isEmpty()) {
+        return false;
+    }
+
+    auto namesOf = [this](const QVector<int>& ids) {
+        QStringList names;
+        for (int id : ids) {
+            names.append(id_to_name.value(id));
+        }
+        return names.join(", ");
+        };
+
+    // 要求表格中必须同组在前、不能同组在后
+    updateConstraintTable();
+
+    logOutput->append(QString("矛盾分析: 以下 %1 条要求无法同时满足，去掉其中任意一条即可:").arg(conflict.size()));
+    for (const ExplainItem& item : conflict) {
+        if (item.kind == ExplainItem::Together) {
+            logOutput->append(QString("  必须同组: %1").arg(namesOf(must_together_groups[item.index])));
+            constraintTable->item(item.index, 2)->setText("存在矛盾");
+        }
+        else if (item.kind == ExplainItem::Separate) {
+            logOutput->append(QString("  不能同组: %1").arg(namesOf(must_separate_groups[item.index])));
+            constraintTable->item(must_together_groups.size() + item.index, 2)->setText("存在矛盾");
+        }
+        else {
+            const FixedPosition& pos = fixedPositions[item.index];
+            logOutput->append(QString("  固定位置: %1 在组%2座位%3")
+                .arg(id_to_name.value(item.index)).arg(pos.groupNumber).arg(pos.seatPosition));
+        }
+    }
+    logOutput->append(QString("矛盾分析用时 %1 ms, 共检查 %2 次").arg(timer.elapsed()).arg(xplain.checks));
+    return true;
+}
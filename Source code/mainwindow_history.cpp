@@ -0,0 +1,155 @@
+#include "mainwindow.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QElapsedTimer>
+
+// 当前分组配置与要求条件，按姓名保存为紧凑JSON
+QByteArray MainWindow::currentConfigJson()
+{
+    QJsonObject root;
+
+    QJsonArray configs;
+    for (int i = 0; i < groupConfigs.size(); i++) {
+        const GroupConfig& config = groupConfigs[i];
+        configs.append(QJsonArray{ config.enabled, config.total, config.males, config.females });
+    }
+    root["groupConfigs"] = configs;
+
+    auto namesOf = [this](const QVector<int>& ids) {
+        QJsonArray names;
+        for (int id : ids) {
+            names.append(id_to_name.value(id));
+        }
+        return names;
+        };
+
+    QJsonArray together;
+    for (const auto& group : must_together_groups) {
+        together.append(namesOf(group));
+    }
+    root["mustTogether"] = together;
+
+    QJsonArray separate;
+    for (const auto& group : must_separate_groups) {
+        separate.append(namesOf(group));
+    }
+    root["mustSeparate"] = separate;
+
+    QJsonArray fixed;
+    for (auto it = fixedPositions.begin(); it != fixedPositions.end(); ++it) {
+        fixed.append(QJsonArray{ id_to_name.value(it.key()), it.value().groupNumber, it.value().seatPosition });
+    }
+    root["fixedPositions"] = fixed;
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+// 将当前 groups 写入分组历史
+void MainWindow::recordSeatingHistory(const QString& label, quint64 seed)
+{
+    SeatingRecord record;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.seed = seed;
+    record.label = label;
+    record.config = currentConfigJson();
+
+    // groups 的下标对应启用组的顺序
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+
+    for (int i = 0; i < groups.size(); i++) {
+        QStringList names;
+        for (int person : groups[i]) {
+            names.append(person == 0 ? QString() : id_to_name.value(person));
+        }
+        record.groupNumbers.append(i < model->groupCount ? model->groupNumber(i) : i + 1);
+        record.groups.append(names);
+    }
+
+    if (!seatingHistory.append(record)) {
+        logOutput->append("警告: 写入分组历史失败");
+    }
+}
+
+void MainWindow::showHistoryDialog()
+{
+    abortBackgroundSolve();
+    QDialog dialog(this);
+    dialog.setWindowTitle("分组历史");
+    dialog.resize(450, 300);
+
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+    layout->addWidget(new QLabel(QString("已记录 %1 次分组结果").arg(seatingHistory.recordCount())));
+
+    // 同组次数查询
+    QGroupBox* pairBox = new QGroupBox("同组次数", &dialog);
+    QHBoxLayout* pairLayout = new QHBoxLayout(pairBox);
+    QLineEdit* nameAEdit = new QLineEdit(&dialog);
+    QLineEdit* nameBEdit = new QLineEdit(&dialog);
+    QPushButton* pairBtn = new QPushButton("查询", &dialog);
+    pairLayout->addWidget(new QLabel("姓名:"));
+    pairLayout->addWidget(nameAEdit);
+    pairLayout->addWidget(new QLabel("和"));
+    pairLayout->addWidget(nameBEdit);
+    pairLayout->addWidget(pairBtn);
+    layout->addWidget(pairBox);
+
+    // 最近一次坐前排查询
+    QGroupBox* frontBox = new QGroupBox("最近一次在前排", &dialog);
+    QGridLayout* frontLayout = new QGridLayout(frontBox);
+    QStringList frontList;
+    for (int groupNumber : frontGroupNumbers) {
+        frontList.append(QString::number(groupNumber));
+    }
+    std::sort(frontList.begin(), frontList.end(), [](const QString& a, const QString& b) {
+        return a.toInt() < b.toInt();
+        });
+    QLineEdit* frontGroupsEdit = new QLineEdit(frontList.join(" "), &dialog);
+    QLineEdit* frontNameEdit = new QLineEdit(&dialog);
+    QPushButton* frontBtn = new QPushButton("查询", &dialog);
+    frontLayout->addWidget(new QLabel("前排组号(空格分隔):"), 0, 0);
+    frontLayout->addWidget(frontGroupsEdit, 0, 1, 1, 2);
+    frontLayout->addWidget(new QLabel("姓名:"), 1, 0);
+    frontLayout->addWidget(frontNameEdit, 1, 1);
+    frontLayout->addWidget(frontBtn, 1, 2);
+    layout->addWidget(frontBox);
+
+    QLabel* resultLabel = new QLabel(&dialog);
+    layout->addWidget(resultLabel);
+
+    QPushButton* closeBtn = new QPushButton("关闭", &dialog);
+    layout->addWidget(closeBtn, 0, Qt::AlignRight);
+
+    connect(pairBtn, &QPushButton::clicked, [&]() {
+        QElapsedTimer timer;
+        timer.start();
+        int count = seatingHistory.pairCount(nameAEdit->text().trimmed(), nameBEdit->text().trimmed());
+        qint64 ns = timer.nsecsElapsed();
+        resultLabel->setText(QString("%1 和 %2 曾同组 %3 次 (查询用时 %4 μs)")
+            .arg(nameAEdit->text().trimmed(), nameBEdit->text().trimmed()).arg(count).arg(ns / 1000.0, 0, 'f', 1));
+        });
+
+    connect(frontBtn, &QPushButton::clicked, [&]() {
+        frontGroupNumbers.clear();
+        for (const QString& entry : frontGroupsEdit->text().split(QRegularExpression("[\\s,]+"), Qt::SkipEmptyParts)) {
+            int groupNumber = entry.toInt();
+            if (groupNumber >= 1 && groupNumber <= 10) {
+                frontGroupNumbers.insert(groupNumber);
+            }
+        }
+
+        QString name = frontNameEdit->text().trimmed();
+        qint64 last = seatingHistory.lastTimeInGroups(name, frontGroupNumbers);
+        if (last < 0) {
+            resultLabel->setText(QString("%1 从未在前排").arg(name));
+        }
+        else {
+            resultLabel->setText(QString("%1 最近一次在前排: %2")
+                .arg(name, QDateTime::fromMSecsSinceEpoch(last).toString("yyyy-MM-dd hh:mm")));
+        }
+        });
+
+    connect(closeBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+
+    dialog.exec();
+}
@@ -0,0 +1,209 @@
+#include "mainwindow.h"
+#include <QElapsedTimer>
+#include <climits>
+
+// 名单增删后的增量调整：保留现有分组，只修复受影响的组
+// previousGroupNames 为名单变动前各组成员的姓名（按启用组顺序）
+bool MainWindow::incrementalResolve(const QVector<QStringList>& previousGroupNames)
+{
+    abortBackgroundSolve();
+    QElapsedTimer timer;
+    timer.start();
+
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    if (model->groupCount != previousGroupNames.size()) {
+        logOutput->append("分组设置已改变，无法增量调整");
+        return false;
+    }
+
+    // 第一步：按姓名映射到新ID，离开的人留下空位（0）
+    QVector<QVector<int>> local_groups(model->groupCount);
+    QVector<bool> placed(model->personCount + 1, false);
+    QVector<bool> touched(model->groupCount, false);
+    int leftCount = 0;
+
+    for (int g = 0; g < model->groupCount; g++) {
+        for (const QString& name : previousGroupNames[g]) {
+            int id = name_to_id.value(name, 0);
+            if (id == 0) {
+                local_groups[g].append(0);
+                touched[g] = true;
+                leftCount++;
+            }
+            else {
+                local_groups[g].append(id);
+                placed[id] = true;
+            }
+        }
+    }
+
+    AssignmentScore score;
+    score.build(model, local_groups);
+
+    auto occupiedCount = [&](int g) {
+        int count = 0;
+        for (int person : local_groups[g]) {
+            if (person != 0) count++;
+        }
+        return count;
+        };
+
+    auto placeInto = [&](int person, int g) {
+        int hole = local_groups[g].indexOf(0);
+        if (hole != -1) {
+            local_groups[g][hole] = person;
+        }
+        else {
+            local_groups[g].append(person);
+        }
+        };
+
+    // 第二步：新加入的人放到代价增加最少且有空位的组
+    int joinedCount = 0;
+    for (int person = 1; person <= model->personCount; person++) {
+        if (placed[person]) continue;
+
+        // 有固定位置的新成员只能进入固定的组
+        int fixedGroup = model->isFixed(person) ? model->fixedGroup(person) : -1;
+        int bestGroup = -1;
+        int bestDelta = INT_MAX;
+        bool bestHasSeat = false;
+        for (int g = 0; g < model->groupCount; g++) {
+            if (fixedGroup >= 0 && g != fixedGroup) continue;
+            bool hasSeat = occupiedCount(g) < model->capacity[g];
+            int delta = score.moveDelta(person, g);
+            if ((hasSeat && !bestHasSeat) || (hasSeat == bestHasSeat && delta < bestDelta)) {
+                bestGroup = g;
+                bestDelta = delta;
+                bestHasSeat = hasSeat;
+            }
+        }
+
+        if (bestGroup == -1) continue;
+        if (!bestHasSeat) {
+            logOutput->append(QString("警告: 没有空座位，%1 被加入组%2（超出人数）")
+                .arg(id_to_name.value(person)).arg(bestGroup + 1));
+        }
+
+        placeInto(person, bestGroup);
+        score.applyMove(person, bestGroup);
+        placed[person] = true;
+        touched[bestGroup] = true;
+        joinedCount++;
+    }
+
+    int penaltyBefore = score.total();
+
+    // 第三步：修复。每次在受影响的组中选代价下降最多的单人移动或交换，
+    // 下降相同时优先移动人数少的方案，直到没有能降低代价的操作
+    auto seatOf = [&](int person, int g) {
+        return local_groups[g].indexOf(person);
+        };
+
+    int movedPeople = 0;
+    const int maxRepairSteps = 100;
+    for (int step = 0; step < maxRepairSteps && score.total() > 0; step++) {
+        for (int g : score.violatedGroups()) {
+            touched[g] = true;
+        }
+
+        int bestDelta = 0;
+        int bestCost = INT_MAX;
+        int bestA = -1, bestB = -1, bestTarget = -1;
+
+        for (int g = 0; g < model->groupCount; g++) {
+            if (!touched[g]) continue;
+
+            for (int a : local_groups[g]) {
+                if (a == 0 || model->isFixed(a)) continue;
+
+                // 单人移动到有空位的组
+                for (int h = 0; h < model->groupCount; h++) {
+                    if (h == g || occupiedCount(h) >= model->capacity[h]) continue;
+                    int delta = score.moveDelta(a, h);
+                    if (delta < bestDelta || (delta == bestDelta && delta < 0 && 1 < bestCost)) {
+                        bestDelta = delta;
+                        bestCost = 1;
+                        bestA = a;
+                        bestB = -1;
+                        bestTarget = h;
+                    }
+                }
+
+                // 与其他组的人交换
+                for (int h = 0; h < model->groupCount; h++) {
+                    if (h == g) continue;
+                    for (int b : local_groups[h]) {
+                        if (b == 0 || model->isFixed(b)) continue;
+                        int delta = score.swapDelta(a, b);
+                        if (delta < bestDelta) {
+                            bestDelta = delta;
+                            bestCost = 2;
+                            bestA = a;
+                            bestB = b;
+                            bestTarget = h;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (bestA == -1) break;
+
+        int fromGroup = score.groupOf(bestA);
+        if (bestB == -1) {
+            local_groups[fromGroup][seatOf(bestA, fromGroup)] = 0;
+            placeInto(bestA, bestTarget);
+            score.applyMove(bestA, bestTarget);
+            logOutput->append(QString("增量调整: %1 从组%2 移动到组%3")
+                .arg(id_to_name.value(bestA)).arg(fromGroup + 1).arg(bestTarget + 1));
+        }
+        else {
+            int seatA = seatOf(bestA, fromGroup);
+            int seatB = seatOf(bestB, bestTarget);
+            std::swap(local_groups[fromGroup][seatA], local_groups[bestTarget][seatB]);
+            score.applySwap(bestA, bestB);
+            logOutput->append(QString("增量调整: %1(组%2) 与 %3(组%4) 交换")
+                .arg(id_to_name.value(bestA)).arg(fromGroup + 1)
+                .arg(id_to_name.value(bestB)).arg(bestTarget + 1));
+        }
+        touched[fromGroup] = true;
+        touched[bestTarget] = true;
+        movedPeople += bestCost;
+    }
+
+    // 移除剩余空位：固定位置的人放回自己的座位，其余的人按原顺序依次补上空出的座位，
+    // 只有固定座位之前的人数不够时才留下空位
+    for (int g = 0; g < model->groupCount; g++) {
+        QVector<int> compact;
+        QVector<int> others;
+        for (int person : local_groups[g]) {
+            if (person == 0) continue;
+            int fs = model->fixedSeat(person);
+            if (model->isFixed(person) && model->fixedGroup(person) == g && fs >= 0) {
+                if (fs >= compact.size()) compact.resize(fs + 1);
+                if (compact[fs] == 0) {
+                    compact[fs] = person;
+                    continue;
+                }
+            }
+            others.append(person);
+        }
+        int seat = 0;
+        for (int person : others) {
+            while (seat < compact.size() && compact[seat] != 0) seat++;
+            if (seat < compact.size()) compact[seat] = person; else compact.append(person);
+            seat++;
+        }
+        local_groups[g] = compact;
+    }
+
+    groups = local_groups;
+    examMode = false;
+    printGroups();
+
+    logOutput->append(QString("增量调整完成: 离开 %1 人, 加入 %2 人, 移动 %3 人, 代价 %4 -> %5, 用时 %6 μs")
+        .arg(leftCount).arg(joinedCount).arg(movedPeople)
+        .arg(penaltyBefore).arg(score.total()).arg(timer.nsecsElapsed() / 1000));
+    return true;
+}
@@ -0,0 +1,152 @@
+#include "mainwindow.h"
+#include "portfolio.h"
+#include <algorithm>
+
+namespace {
+    // 两个方案的组数和人员集合相同：后台结果只能替换同一个问题下的分组
+    bool samePeople(const QVector<QVector<int>>& a, const QVector<QVector<int>>& b)
+    {
+        if (a.size() != b.size()) return false;
+        QVector<int> left, right;
+        for (const QVector<int>& group : a) left += group;
+        for (const QVector<int>& group : b) right += group;
+        left.removeAll(0);
+        right.removeAll(0);
+        std::sort(left.begin(), left.end());
+        std::sort(right.begin(), right.end());
+        return left == right;
+    }
+}
+
+// 贪心结果仍有违反项时，在后台线程运行求解组合，界面定时取出当前最好方案刷新表格。
+// 没有需要改进的地方时返回 false
+bool MainWindow::startBackgroundSolve(qint64 timeBudgetMs)
+{
+    if (solveRunning()) return false;
+
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    if (groups.size() != model->groupCount || model->groupCount < 2) return false;
+
+    AssignmentScore score;
+    score.build(model, groups);
+    if (score.total() == 0) return false;
+
+    solveCancel = std::make_shared<CancelToken>();
+    solveSnapshot = std::make_shared<SolutionSnapshot>();
+    solveResult = std::make_shared<PortfolioResult>();
+    solveSnapshotVersion = 0;
+    solveTimer.start();
+    solveStart = groups;
+
+    QVector<QVector<int>> start = groups;
+    quint64 seed = quint64(lastSeed);
+    std::shared_ptr<CancelToken> cancel = solveCancel;
+    std::shared_ptr<SolutionSnapshot> snapshot = solveSnapshot;
+    std::shared_ptr<PortfolioResult> result = solveResult;
+    solveThread = std::thread([model, start, seed, timeBudgetMs, cancel, snapshot, result]() {
+        SolverPortfolio portfolio(model, seed);
+        *result = portfolio.run(start, timeBudgetMs, cancel.get(), snapshot.get());
+        snapshot->markFinished();
+        });
+
+    setSolveLocked(true);
+    solveRefreshTimer->start();
+    logOutput->append(QString("后台优化开始: 违反代价 %1, 时限 %2 ms").arg(score.total()).arg(timeBudgetMs));
+    return true;
+}
+
+// 定时器回调：有更好的方案时刷新表格，求解结束时收尾
+void MainWindow::refreshBackgroundSolve()
+{
+    if (!solveSnapshot) return;
+
+    int penalty = 0;
+    QVector<QVector<int>> best;
+    if (solveSnapshot->fetch(best, penalty, solveSnapshotVersion) && samePeople(best, solveStart)) {
+        groups = best;
+        printGroups();
+        updateStatus(QString("后台优化中: 当前违反代价 %1, 已用时 %2 ms").arg(penalty).arg(solveTimer.elapsed()));
+    }
+
+    if (solveSnapshot->isFinished()) {
+        finishBackgroundSolve();
+    }
+}
+
+void MainWindow::stopBackgroundSolve()
+{
+    if (!solveCancel) return;
+    solveCancel->cancel();
+    stopSolveBtn->setEnabled(false);
+    updateStatus("正在停止优化，保留当前最好结果...");
+}
+
+void MainWindow::finishBackgroundSolve()
+{
+    solveRefreshTimer->stop();
+    if (solveThread.joinable()) {
+        solveThread.join();
+    }
+
+    const PortfolioResult& result = *solveResult;
+    bool valid = samePeople(result.groups, solveStart);
+    if (valid) {
+        groups = result.groups;
+    }
+    if (!valid) {
+        logOutput->append("组合求解: 结果与当前人员不符，已丢弃");
+    }
+    else if (result.winner.isEmpty()) {
+        logOutput->append(QString("组合求解: 违反代价 %1 未能改进, 用时 %2 ms")
+            .arg(result.initialPenalty).arg(solveTimer.elapsed()));
+    }
+    else {
+        logOutput->append(QString("组合求解: 违反代价 %1 -> %2, 采用「%3」的结果%4%5, 用时 %6 ms")
+            .arg(result.initialPenalty).arg(result.penalty).arg(result.winner)
+            .arg(result.solved ? "（已满足全部要求，其余策略提前停止）" : "")
+            .arg(result.interrupted ? "（达到时限或被停止，结果不能按种子重现）" : "")
+            .arg(solveTimer.elapsed()));
+    }
+
+    solveCancel.reset();
+    solveSnapshot.reset();
+    solveResult.reset();
+    solveStart.clear();
+    setSolveLocked(false);
+
+    if (valid) {
+        recordSeatingHistory("生成分组", lastSeed);
+    }
+    printGroups();
+    updateStatus("分组生成完成");
+}
+
+bool MainWindow::solveRunning() const
+{
+    return solveThread.joinable();
+}
+
+// 改动分组或设置之前调用：停止后台求解并等待线程结束，保留已得到的最好结果，
+// 之后的修改不会再被定时器或收尾覆盖
+void MainWindow::abortBackgroundSolve()
+{
+    if (!solveRunning()) return;
+    solveCancel->cancel();
+    finishBackgroundSolve();
+}
+
+// 求解期间禁用会改动分组或设置的按钮和菜单
+void MainWindow::setSolveLocked(bool locked)
+{
+    generateBtn->setEnabled(!locked);
+    reseatBtn->setEnabled(!locked);
+    resetBtn->setEnabled(!locked);
+    addConstraintBtn->setEnabled(!locked);
+    removeConstraintBtn->setEnabled(!locked);
+    stopSolveBtn->setEnabled(locked);
+    for (QAction* action : solveLockedActions) {
+        action->setEnabled(!locked);
+    }
+    groupModel->setMovesEnabled(!locked);
+    updateEditActions();
+}
@@ -0,0 +1,348 @@
+#include "mainwindow.h"
+#include <QDragMoveEvent>
+#include <QElapsedTimer>
+#include <climits>
+
+// 手动移动：拖放或右键菜单把一个人移到指定座位
+// 悬停时的提示只试算这个人和交换对象，代价与班级人数无关
+
+void MainWindow::prepareManualMove()
+{
+    manualModel = compileProblemModel();
+    manualScore.build(manualModel, groups);
+    manualHoverCell = Position();
+}
+
+ManualMove MainWindow::planManualMove(int personId, int targetGroup, int targetSeat)
+{
+    ManualMove move;
+    move.person = personId;
+
+    if (examMode) {
+        move.reason = "考场模式不支持手动移动";
+        return move;
+    }
+    if (solveRunning()) {
+        move.reason = "后台求解进行中";
+        return move;
+    }
+    if (!manualModel || manualModel->groupCount != groups.size()) {
+        move.reason = "分组设置已改变，请重新生成分组";
+        return move;
+    }
+    if (targetGroup < 0 || targetGroup >= groups.size() || targetSeat < 0 || targetSeat >= groups[targetGroup].size()) {
+        move.reason = "目标座位不存在";
+        return move;
+    }
+
+    const ProblemModel& model = *manualModel;
+    int fromGroup = personId >= 1 && personId <= model.personCount ? manualScore.groupOf(personId) : -1;
+    int fromSeat = fromGroup >= 0 ? groups[fromGroup].indexOf(personId) : -1;
+    if (fromSeat < 0) {
+        move.reason = QString("未找到人员 %1").arg(id_to_name.value(personId));
+        return move;
+    }
+    if (fromGroup == targetGroup && fromSeat == targetSeat) {
+        move.reason = "已在该座位";
+        return move;
+    }
+
+    // 移动后各人的位置，用于检查固定位置
+    QVector<QPair<int, Position>> landings;
+    int occupant = groups[targetGroup][targetSeat];
+    landings.append({ personId, Position(targetGroup, targetSeat) });
+
+    // 占座的人固定在这个座位上时不能把他换走；固定在别处时按异性处理，另找可交换的成员
+    bool occupantFixed = occupant != 0 && model.isFixed(occupant);
+    if (occupantFixed && model.fixedGroup(occupant) == targetGroup && model.fixedSeat(occupant) == targetSeat) {
+        move.reason = QString("%1 固定在该座位").arg(id_to_name.value(occupant));
+        return move;
+    }
+
+    if (fromGroup == targetGroup) {
+        move.steps.append(qMakePair(Position(fromGroup, fromSeat), Position(targetGroup, targetSeat)));
+        if (occupant != 0) landings.append({ occupant, Position(fromGroup, fromSeat) });
+    }
+    else if (occupant != 0 && !occupantFixed && model.isMale(occupant) == model.isMale(personId)) {
+        move.partner = occupant;
+        move.steps.append(qMakePair(Position(fromGroup, fromSeat), Position(targetGroup, targetSeat)));
+        landings.append({ occupant, Position(fromGroup, fromSeat) });
+    }
+    else {
+        // 目标座位是异性、空位或有固定位置的人：与目标组中交换代价最小的同性别可移动成员交换，
+        // 再组内换座，各组男女人数不变
+        int partnerSeat = -1;
+        int bestDelta = INT_MAX;
+        for (int s = 0; s < groups[targetGroup].size(); s++) {
+            int other = groups[targetGroup][s];
+            if (other == 0 || model.isMale(other) != model.isMale(personId) || model.isFixed(other)) continue;
+            int delta = manualScore.swapDelta(personId, other);
+            if (delta < bestDelta) {
+                bestDelta = delta;
+                partnerSeat = s;
+            }
+        }
+        if (partnerSeat < 0) {
+            move.reason = QString("组%1中没有可交换的同性别成员").arg(targetGroup + 1);
+            return move;
+        }
+        move.partner = groups[targetGroup][partnerSeat];
+        move.steps.append(qMakePair(Position(fromGroup, fromSeat), Position(targetGroup, partnerSeat)));
+        move.steps.append(qMakePair(Position(targetGroup, partnerSeat), Position(targetGroup, targetSeat)));
+        landings.append({ move.partner, Position(fromGroup, fromSeat) });
+        if (occupant != 0) landings.append({ occupant, Position(targetGroup, partnerSeat) });
+    }
+
+    for (const auto& landing : landings) {
+        int id = landing.first;
+        if (!model.isFixed(id)) continue;
+        if (model.fixedGroup(id) != landing.second.group || model.fixedSeat(id) != landing.second.seat) {
+            move.warnings.append(QString("%1 将离开固定位置").arg(id_to_name.value(id)));
+        }
+    }
+
+    // 组内换座不改变任何计数；跨组时只有两个人所属的要求和两个组的计数会变
+    if (move.partner != 0) {
+        struct Watched {
+            bool together;
+            int set;
+            bool before;
+        };
+        QVector<Watched> watched;
+        auto satisfiedNow = [&](bool together, int s) {
+            if (together) return manualScore.togetherSatisfied(s);
+            return manualScore.separateCountIn(s, fromGroup) <= 1 && manualScore.separateCountIn(s, targetGroup) <= 1;
+            };
+        auto watch = [&](bool together, IdRange sets) {
+            for (int s : sets) {
+                bool seen = false;
+                for (const Watched& w : watched) {
+                    if (w.together == together && w.set == s) seen = true;
+                }
+                if (!seen) watched.append({ together, s, satisfiedNow(together, s) });
+            }
+            };
+        for (int id : { personId, move.partner }) {
+            watch(true, model.togetherSetsOf(id));
+            watch(false, model.separateSetsOf(id));
+        }
+
+        int before = manualScore.total();
+        manualScore.applySwap(personId, move.partner);
+        move.penaltyDelta = manualScore.total() - before;
+        for (const Watched& w : watched) {
+            bool after = satisfiedNow(w.together, w.set);
+            if (after == w.before) continue;
+            QStringList names;
+            for (int id : w.together ? model.togetherSet(w.set) : model.separateSet(w.set)) {
+                names.append(id_to_name.value(id));
+            }
+            QString text = QString("%1（%2）").arg(w.together ? "必须同组" : "必须分开", names.join("、"));
+            (after ? move.satisfied : move.broken).append(text);
+        }
+        manualScore.applySwap(personId, move.partner);
+    }
+
+    move.allowed = true;
+    return move;
+}
+
+QString MainWindow::describeManualMove(const ManualMove& move)
+{
+    if (!move.allowed) return "无法移动：" + move.reason;
+
+    QStringList lines;
+    if (move.partner == 0) {
+        lines << "组内换座";
+    }
+    else if (move.steps.size() == 1) {
+        lines << QString("与 %1 交换").arg(id_to_name.value(move.partner));
+    }
+    else {
+        lines << QString("与 %1 交换后组内换座").arg(id_to_name.value(move.partner));
+    }
+    if (move.penaltyDelta != 0) {
+        lines << QString("违反代价 %1%2").arg(move.penaltyDelta > 0 ? "+" : "").arg(move.penaltyDelta);
+    }
+    if (!move.satisfied.isEmpty()) lines << "满足: " + move.satisfied.join("；");
+    if (!move.broken.isEmpty()) lines << "违反: " + move.broken.join("；");
+    for (const QString& warning : move.warnings) {
+        lines << "注意: " + warning;
+    }
+    return lines.join("\n");
+}
+
+bool MainWindow::applyManualMove(const ManualMove& move)
+{
+    if (!move.allowed) return false;
+
+    if (!applySwapBatch(move.steps, true)) return false;
+
+    const Position& target = move.steps.last().second;
+    logOutput->append(QString("成功移动 %1 到组%2位置%3")
+        .arg(id_to_name.value(move.person)).arg(target.group + 1).arg(target.seat + 1));
+    for (const QString& text : move.broken) {
+        logOutput->append("警告: 移动后违反要求 " + text);
+    }
+    for (const QString& warning : move.warnings) {
+        logOutput->append("警告: " + warning);
+    }
+    return true;
+}
+
+void MainWindow::requestManualMove(int personId, int targetGroup, int targetSeat)
+{
+    prepareManualMove();
+    ManualMove move = planManualMove(personId, targetGroup, targetSeat);
+    if (!move.allowed) {
+        logOutput->append("错误: " + move.reason);
+        return;
+    }
+    editHistory.beginStep(QString("移动 %1 到组%2位置%3")
+        .arg(id_to_name.value(personId)).arg(targetGroup + 1).arg(targetSeat + 1), groups);
+    applyManualMove(move);
+    editHistory.endStep(groups);
+    updateEditActions();
+}
+
+// 推荐交换：列出代价下降最多的几个两人交换或三人循环，选中后依次做跨组交换
+void MainWindow::showSwapSuggestions(int personId, const QPoint& globalPos)
+{
+    prepareManualMove();
+    if (examMode || solveRunning() || manualModel->groupCount != groups.size()) {
+        logOutput->append("错误: 当前无法推荐交换");
+        return;
+    }
+    if (manualModel->isFixed(personId)) {
+        logOutput->append(QString("%1 有固定位置，不推荐交换").arg(id_to_name.value(personId)));
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    SwapAdvisor advisor(manualModel);
+    SwapAdvice advice = advisor.suggest(groups, personId);
+    logOutput->append(QString("推荐交换: 为 %1 试算 %2 个方案，用时 %3 ms")
+        .arg(id_to_name.value(personId)).arg(advice.evaluated).arg(timer.elapsed()));
+    if (advice.suggestions.isEmpty()) {
+        logOutput->append("没有可交换的同性别人员");
+        return;
+    }
+
+    QMenu menu(this);
+    for (int i = 0; i < advice.suggestions.size(); i++) {
+        const SwapSuggestion& suggestion = advice.suggestions[i];
+        QStringList moves;
+        for (int k = 0; k < suggestion.cycle.size(); k++) {
+            int next = suggestion.cycle[(k + 1) % suggestion.cycle.size()];
+            moves << QString("%1 → 组%2").arg(id_to_name.value(suggestion.cycle[k]))
+                .arg(manualScore.groupOf(next) + 1);
+        }
+        QString delta = suggestion.penaltyDelta == 0 ? "代价不变"
+            : QString("违反代价 %1%2").arg(suggestion.penaltyDelta > 0 ? "+" : "").arg(suggestion.penaltyDelta);
+        menu.addAction(QString("%1（%2）").arg(moves.join("，"), delta))->setData(i);
+    }
+
+    QAction* chosen = menu.exec(globalPos);
+    if (!chosen) return;
+    const SwapSuggestion& suggestion = advice.suggestions[chosen->data().toInt()];
+
+    // 依次与第一人的座位交换：第 k 人换到第一人的座位后再被下一人换走，最终每人到达下一人的位置
+    QVector<Position> seats;
+    for (int id : suggestion.cycle) {
+        int g = manualScore.groupOf(id);
+        seats.append(Position(g, groups[g].indexOf(id)));
+    }
+    QVector<QPair<Position, Position>> swaps;
+    for (int k = 1; k < seats.size(); k++) {
+        swaps.append(qMakePair(seats[0], seats[k]));
+    }
+    editHistory.beginStep(chosen->text(), groups);
+    applySwapBatch(swaps, true);
+    editHistory.endStep(groups);
+    updateEditActions();
+}
+
+void MainWindow::undoEdit()
+{
+    jumpToEdit(editHistory.currentStep() - 1);
+}
+
+void MainWindow::redoEdit()
+{
+    jumpToEdit(editHistory.currentStep() + 1);
+}
+
+// 撤销/重做到已应用 step 步的状态：按记录原地交换座位，表格和座位图只刷新变化的单元格
+void MainWindow::jumpToEdit(int step)
+{
+    if (solveRunning()) return;
+    if (!editHistory.matches(groups)) {
+        editHistory.clear();
+        updateEditActions();
+        updateStatus("分组已重新生成或读取，之前的调整记录已清空");
+        return;
+    }
+    int current = editHistory.currentStep();
+    if (step < 0 || step > editHistory.stepCount() || step == current) return;
+
+    for (const EditHistory::SeatSwap& swap : editHistory.swapsTo(step)) {
+        std::swap(groups[swap.groupA][swap.seatA], groups[swap.groupB][swap.seatB]);
+    }
+    editHistory.setCurrent(step, groups);
+    printGroups();
+    prepareManualMove();
+    updateEditActions();
+
+    QString message;
+    if (step == current - 1) {
+        message = "撤销: " + editHistory.stepLabel(step);
+    }
+    else if (step == current + 1) {
+        message = "重做: " + editHistory.stepLabel(current);
+    }
+    else {
+        message = QString("已回到第 %1 步调整之后").arg(step);
+    }
+    // 与 applySwapBatch 一样按恢复后的分组重新评分
+    if (!examMode && manualModel->groupCount == groups.size()) {
+        message += QString("，当前违反代价 %1").arg(manualScore.total());
+    }
+    updateStatus(message);
+}
+
+void MainWindow::updateEditActions()
+{
+    int current = editHistory.currentStep();
+    bool idle = !solveRunning();
+    undoAction->setEnabled(idle && current > 0);
+    redoAction->setEnabled(idle && current < editHistory.stepCount());
+    undoAction->setText(current > 0 ? "撤销 " + editHistory.stepLabel(current - 1) : "撤销");
+    redoAction->setText(current < editHistory.stepCount() ? "重做 " + editHistory.stepLabel(current) : "重做");
+
+    editHistoryMenu->setEnabled(idle && editHistory.stepCount() > 0);
+}
+
+// 表格拖放：进入时建立评分，单元格变化时才重新试算，提示显示在状态栏
+bool MainWindow::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == groupTable->viewport()) {
+        if (event->type() == QEvent::DragEnter) {
+            if (GroupTableModel::draggedPerson(static_cast<QDragEnterEvent*>(event)->mimeData()) != 0) {
+                prepareManualMove();
+            }
+        }
+        else if (event->type() == QEvent::DragMove) {
+            QDragMoveEvent* dragEvent = static_cast<QDragMoveEvent*>(event);
+            int person = GroupTableModel::draggedPerson(dragEvent->mimeData());
+            QModelIndex index = groupTable->indexAt(dragEvent->position().toPoint());
+            Position cell(index.row(), index.column() - 1);
+            if (person != 0 && index.isValid() && index.column() > 0 && !(cell == manualHoverCell)) {
+                manualHoverCell = cell;
+                QString text = describeManualMove(planManualMove(person, cell.group, cell.seat));
+                statusLabel->setText(text.replace("\n", "；"));
+            }
+        }
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
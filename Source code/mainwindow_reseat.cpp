@@ -0,0 +1,223 @@
+#include "mainwindow.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+// 违反要求的代价远大于任何移动代价，保证先满足要求，再尽量少动
+const qint64 VIOLATION_WEIGHT = 100000;
+
+// 组与组之间的距离按3个座位计
+const int GROUP_SPACING = 3;
+
+struct SeatPos {
+    int group;
+    int seat;
+};
+
+int seatDistance(const SeatPos& a, const SeatPos& b, bool byDistance)
+{
+    if (a.group == b.group && a.seat == b.seat) return 0;
+    if (!byDistance) return 1;
+    return std::abs(a.group - b.group) * GROUP_SPACING + std::abs(a.seat - b.seat);
+}
+
+} // namespace
+
+// 在当前分组基础上满足新要求，同时让移动的人数（或移动距离）最少
+// 采用大邻域搜索：每轮拆出违反要求的成员和少量随机人员，再逐个贪心放回空出的座位
+void MainWindow::minimalDisruptionReseat()
+{
+    abortBackgroundSolve();
+    if (groups.isEmpty() || examMode) {
+        QMessageBox::warning(this, "错误", "请先生成分组结果");
+        return;
+    }
+
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    if (model->groupCount != groups.size()) {
+        QMessageBox::warning(this, "错误", "分组设置已改变，请重新生成分组");
+        return;
+    }
+
+    bool byDistance = reseatMetricCombo->currentData().toBool();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 原始座位
+    QVector<SeatPos> original(model->personCount + 1, SeatPos{ -1, -1 });
+    for (int g = 0; g < groups.size(); g++) {
+        for (int s = 0; s < groups[g].size(); s++) {
+            int person = groups[g][s];
+            if (person >= 1 && person <= model->personCount) original[person] = SeatPos{ g, s };
+        }
+    }
+
+    QVector<QVector<int>> current = groups;
+
+    // 先把有固定位置的人放到指定座位，与占座的人对调；之后的搜索不再移动他们
+    int fixedMoved = 0;
+    int fixedFailed = 0;
+    for (int person = 1; person <= model->personCount; person++) {
+        int fg = model->fixedGroup(person);
+        int fs = model->fixedSeat(person);
+        if (!model->isFixed(person) || fg < 0 || original[person].group < 0) continue;
+
+        int pg = -1, ps = -1;
+        for (int k = 0; k < current.size() && pg < 0; k++) {
+            ps = current[k].indexOf(person);
+            if (ps >= 0) pg = k;
+        }
+        if (pg == fg && ps == fs) continue;
+
+        if (fs >= current[fg].size()) {
+            if (fs >= model->capacity[fg]) {
+                fixedFailed++;
+                continue;
+            }
+            current[fg].resize(fs + 1);
+        }
+        int occupant = current[fg][fs];
+        if (occupant >= 1 && model->isFixed(occupant) &&
+            model->fixedGroup(occupant) == fg && model->fixedSeat(occupant) == fs) {
+            fixedFailed++;
+            continue;
+        }
+        current[pg][ps] = occupant;
+        current[fg][fs] = person;
+        fixedMoved++;
+    }
+
+    AssignmentScore score;
+    score.build(model, current);
+
+    auto disruptionOf = [&](const QVector<QVector<int>>& plan, bool distanceMetric) {
+        qint64 total = 0;
+        for (int g = 0; g < plan.size(); g++) {
+            for (int s = 0; s < plan[g].size(); s++) {
+                int person = plan[g][s];
+                if (person >= 1 && person <= model->personCount) {
+                    total += seatDistance(original[person], SeatPos{ g, s }, distanceMetric);
+                }
+            }
+        }
+        return total;
+        };
+
+    int initialViolations = score.total();
+    qint64 currentCost = qint64(score.total()) * VIOLATION_WEIGHT + disruptionOf(current, byDistance);
+    QVector<QVector<int>> best = current;
+    qint64 bestCost = currentCost;
+
+    std::random_device rd;
+    std::mt19937 g(rd());
+
+    QVector<int> movablePeople;
+    for (int person = 1; person <= model->personCount; person++) {
+        if (!model->isFixed(person) && original[person].group >= 0) movablePeople.append(person);
+    }
+    if (movablePeople.isEmpty()) {
+        logOutput->append("没有可移动的人员");
+    }
+    std::uniform_int_distribution<int> personDist(0, qMax(0, movablePeople.size() - 1));
+
+    const qint64 timeBudgetMs = 300;
+    const int maxIterations = movablePeople.isEmpty() ? 0 : 20000;
+    int iteration = 0;
+
+    for (; iteration < maxIterations && timer.elapsed() < timeBudgetMs; iteration++) {
+        // 拆除：违反要求的组里随机一组的成员 + 若干随机人员
+        QVector<int> removed;
+        QVector<bool> isRemoved(model->personCount + 1, false);
+        auto removePerson = [&](int person) {
+            if (person < 1 || person > model->personCount || isRemoved[person] || model->isFixed(person)) return;
+            isRemoved[person] = true;
+            removed.append(person);
+            };
+
+        QVector<int> violated = score.violatedGroups();
+        if (!violated.isEmpty()) {
+            int vg = violated[std::uniform_int_distribution<int>(0, violated.size() - 1)(g)];
+            for (int person : current[vg]) {
+                removePerson(person);
+            }
+        }
+        int extra = std::uniform_int_distribution<int>(2, 6)(g);
+        for (int k = 0; k < extra; k++) {
+            removePerson(movablePeople[personDist(g)]);
+        }
+        if (removed.size() < 2) continue;
+
+        // 记录拆除前状态以便回退
+        QVector<QVector<int>> backup = current;
+        QVector<SeatPos> freeSeats;
+        for (int person : removed) {
+            int pg = score.groupOf(person);
+            int ps = current[pg].indexOf(person);
+            current[pg][ps] = 0;
+            freeSeats.append(SeatPos{ pg, ps });
+            score.applyMove(person, -1);
+        }
+
+        // 修复：有要求的人优先，逐个放到使总代价增加最少的空座
+        std::shuffle(removed.begin(), removed.end(), g);
+        std::stable_sort(removed.begin(), removed.end(), [&](int a, int b) {
+            int ca = model->togetherSetsOf(a).size() + model->separateSetsOf(a).size() + (model->isLeader(a) ? 1 : 0);
+            int cb = model->togetherSetsOf(b).size() + model->separateSetsOf(b).size() + (model->isLeader(b) ? 1 : 0);
+            return ca > cb;
+            });
+
+        for (int person : removed) {
+            int bestSeat = -1;
+            qint64 bestInsert = LLONG_MAX;
+            for (int k = 0; k < freeSeats.size(); k++) {
+                const SeatPos& seat = freeSeats[k];
+                qint64 cost = qint64(score.moveDelta(person, seat.group)) * VIOLATION_WEIGHT +
+                    seatDistance(original[person], seat, byDistance);
+                if (cost < bestInsert) {
+                    bestInsert = cost;
+                    bestSeat = k;
+                }
+            }
+
+            SeatPos seat = freeSeats.takeAt(bestSeat);
+            current[seat.group][seat.seat] = person;
+            score.applyMove(person, seat.group);
+        }
+
+        qint64 newCost = qint64(score.total()) * VIOLATION_WEIGHT + disruptionOf(current, byDistance);
+        if (newCost <= currentCost) {
+            currentCost = newCost;
+            if (newCost < bestCost) {
+                bestCost = newCost;
+                best = current;
+            }
+        }
+        else {
+            current = backup;
+            score.build(model, current);
+        }
+    }
+
+    AssignmentScore finalScore;
+    finalScore.build(model, best);
+
+    groups = best;
+    printGroups();
+
+    logOutput->append(QString("最小变动调整完成: 要求代价 %1 -> %2, 移动 %3 人, 总移动距离 %4, 迭代 %5 次, 用时 %6 ms")
+        .arg(initialViolations).arg(finalScore.total())
+        .arg(disruptionOf(best, false)).arg(disruptionOf(best, true))
+        .arg(iteration).arg(timer.elapsed()));
+    if (fixedMoved > 0 || fixedFailed > 0) {
+        logOutput->append(QString("固定位置: 调整 %1 人, 无法安排 %2 人").arg(fixedMoved).arg(fixedFailed));
+    }
+    if (finalScore.total() > 0) {
+        logOutput->append("警告: 仍有部分要求未满足，可尝试重新生成分组");
+    }
+    updateStatus("最小变动调整完成");
+}
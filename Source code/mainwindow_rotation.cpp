@@ -0,0 +1,288 @@
+#include "mainwindow.h"
+#include "groupkernels.h"
+#include "taskpool.h"
+#include <QHeaderView>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// 统计一周分组中所有同组人员对
+void addWeekPairs(const QVector<QVector<int>>& week, QVector<quint16>& pairCounts, int sign)
+{
+    for (const auto& group : week) {
+        for (int i = 0; i < group.size(); i++) {
+            for (int j = i + 1; j < group.size(); j++) {
+                if (group[i] == 0 || group[j] == 0) continue;
+                pairCounts[pairIndex(group[i], group[j])] += sign;
+            }
+        }
+    }
+}
+
+// 重复同组的总代价：每对人员共现 c 次计 c*(c-1)/2
+qint64 repeatPenalty(const QVector<quint16>& pairCounts)
+{
+    qint64 penalty = 0;
+    for (quint16 c : pairCounts) {
+        penalty += qint64(c) * (c - 1) / 2;
+    }
+    return penalty;
+}
+
+// 人员移入目标组后是否会与不能同组要求冲突（exclude 为将被换出的人）
+bool violatesSeparate(const ProblemModel& model, const QVector<int>& targetGroup, int person, int exclude)
+{
+    for (int setIdx : model.separateSetsOf(person)) {
+        IdRange members = model.separateSet(setIdx);
+        for (int other : targetGroup) {
+            if (other == exclude || other == person) continue;
+            if (members.contains(other)) return true;
+        }
+    }
+    return false;
+}
+
+// 在其他周的共现次数固定的前提下优化某一周：
+// 总代价对这一周来说等价于本周所有同组人员对的历史共现次数之和
+// movable 标记可参与交换的人：固定位置、组长、必须同组成员不参与
+// 交换代价由 GroupKernel 按两个组各自的人数选择展开版本或通用版本计算
+QVector<QVector<int>> optimizeRotationWeek(const ProblemModel& model, const QVector<bool>& movable,
+    QVector<QVector<int>> week, const QVector<quint16>& otherCounts, quint64 seed)
+{
+    CounterRng g(seed, 0, RngPhase::Rotation);
+    const quint16* counts = otherCounts.constData();
+
+    // 候选交换对：不同组、同性别、都可移动、外宿生身份相同（保持性别配额和外宿生平衡）
+    struct Slot { int group; int seat; };
+    QVector<Slot> slots;
+    for (int gi = 0; gi < week.size(); gi++) {
+        for (int s = 0; s < week[gi].size(); s++) {
+            int p = week[gi][s];
+            if (p != 0 && movable[p]) slots.append({ gi, s });
+        }
+    }
+
+    const int maxPasses = 50;
+    for (int pass = 0; pass < maxPasses; pass++) {
+        std::shuffle(slots.begin(), slots.end(), g);
+        bool improved = false;
+
+        for (int i = 0; i < slots.size(); i++) {
+            for (int j = i + 1; j < slots.size(); j++) {
+                const Slot& sa = slots[i];
+                const Slot& sb = slots[j];
+                if (sa.group == sb.group) continue;
+
+                int a = week[sa.group][sa.seat];
+                int b = week[sb.group][sb.seat];
+                if (model.isMale(a) != model.isMale(b) || model.isBoarder(a) != model.isBoarder(b)) continue;
+
+                const QVector<int>& ga = week[sa.group];
+                const QVector<int>& gb = week[sb.group];
+                int delta = GroupKernel::swapDelta(ga, a, b, counts) + GroupKernel::swapDelta(gb, b, a, counts);
+                if (delta >= 0) continue;
+
+                if (violatesSeparate(model, gb, a, b) || violatesSeparate(model, ga, b, a)) continue;
+
+                week[sa.group][sa.seat] = b;
+                week[sb.group][sb.seat] = a;
+                improved = true;
+            }
+        }
+
+        if (!improved) break;
+    }
+    return week;
+}
+
+} // namespace
+
+void MainWindow::generateRotationPlan(int weekCount)
+{
+    if (weekCount < 1) return;
+    abortBackgroundSolve();
+
+    int personCount = male_names.size() + female_names.size();
+    if (personCount < 2) {
+        QMessageBox::warning(this, "错误", "名单人数不足，无法生成轮换计划");
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 第一步：用现有算法为每一周生成满足组长、外宿生、固定位置要求的初始分组
+    QVector<QVector<QVector<int>>> plans;
+    QVector<quint32> weekSeeds;
+    for (int w = 0; w < weekCount; w++) {
+        logOutput->append(QString("生成第%1周初始分组...").arg(w + 1));
+        auto result = initializeGroupsWithConstraints();
+        if (result.first.isEmpty()) {
+            return;
+        }
+        groups = result.first;
+        plans.append(result.first);
+        weekSeeds.append(lastSeed);
+    }
+    examMode = false;
+
+    // 第二步：编译只读问题模型，各工作线程共享
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    QVector<bool> movable(personCount + 1, false);
+    for (int id = 1; id <= personCount; id++) {
+        movable[id] = !model->isLeader(id) && !model->isFixed(id) && model->togetherSetsOf(id).isEmpty();
+    }
+
+    // 第三步：多周联合并行优化
+    // 每一轮中各周作为求解线程池中的任务，针对其他周的共现次数（轮初快照）同时求解，
+    // 轮末按随机顺序逐周合并：只有在当前真实共现次数下确实降低总代价的新方案才被采纳，保证总代价单调下降
+    // 共现次数以分组历史为底，使新计划同时避开以往学期已经同组过的人
+    QVector<quint16> pairCounts(personCount * (personCount - 1) / 2, 0);
+    if (seatingHistory.recordCount() > 0) {
+        for (int a = 2; a <= personCount; a++) {
+            for (int b = 1; b < a; b++) {
+                pairCounts[pairIndex(a, b)] = quint16(seatingHistory.pairCount(id_to_name.value(a), id_to_name.value(b)));
+            }
+        }
+    }
+    for (const auto& week : plans) {
+        addWeekPairs(week, pairCounts, 1);
+    }
+    qint64 initialPenalty = repeatPenalty(pairCounts);
+
+    // 各周各轮使用由第一周种子派生的独立随机数流，结果与线程调度无关
+    quint64 rootSeed = weekSeeds.first();
+    CounterRng mergeRng(rootSeed, 0, RngPhase::RotationMerge);
+    const int maxRounds = 30;
+    for (int round = 0; round < maxRounds; round++) {
+        std::vector<QVector<QVector<int>>> results(weekCount);
+        QVector<quint64> seeds(weekCount);
+        for (int w = 0; w < weekCount; w++) {
+            seeds[w] = CounterRng::streamKey(rootSeed, quint64(round) * weekCount + w, RngPhase::Rotation);
+        }
+
+        TaskPool::TaskGroup tasks;
+        for (int w = 0; w < weekCount; w++) {
+            QVector<quint16> otherCounts = pairCounts;
+            addWeekPairs(plans[w], otherCounts, -1);
+            QVector<QVector<int>> week = plans[w];
+            tasks.run([model, &movable, &results, w, week, otherCounts, seed = seeds[w]]() {
+                results[w] = optimizeRotationWeek(*model, movable, week, otherCounts, seed);
+                });
+        }
+        tasks.wait();
+
+        QVector<int> mergeOrder;
+        for (int w = 0; w < weekCount; w++) {
+            mergeOrder.append(w);
+        }
+        std::shuffle(mergeOrder.begin(), mergeOrder.end(), mergeRng);
+
+        int accepted = 0;
+        for (int w : mergeOrder) {
+            qint64 before = repeatPenalty(pairCounts);
+            addWeekPairs(plans[w], pairCounts, -1);
+            addWeekPairs(results[w], pairCounts, 1);
+            if (repeatPenalty(pairCounts) < before) {
+                plans[w] = results[w];
+                accepted++;
+            }
+            else {
+                addWeekPairs(results[w], pairCounts, -1);
+                addWeekPairs(plans[w], pairCounts, 1);
+            }
+        }
+
+        if (accepted == 0) break;
+    }
+
+    qint64 finalPenalty = repeatPenalty(pairCounts);
+    rotationPlans = plans;
+
+    // 每周结果都记入分组历史
+    for (int w = 0; w < weekCount; w++) {
+        groups = rotationPlans[w];
+        recordSeatingHistory(QString("轮换第%1周").arg(w + 1), weekSeeds[w]);
+    }
+
+    groups = rotationPlans.first();
+    printGroups();
+
+    logOutput->append(QString("轮换计划完成: %1 周, 重复同组代价 %2 -> %3, 用时 %4 ms")
+        .arg(weekCount).arg(initialPenalty).arg(finalPenalty).arg(timer.elapsed()));
+    updateStatus(QString("已生成 %1 周轮换计划").arg(weekCount));
+}
+
+void MainWindow::showRotationDialog()
+{
+    abortBackgroundSolve();
+    QDialog dialog(this);
+    dialog.setWindowTitle("轮换计划");
+    dialog.resize(400, 200);
+
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+
+    QHBoxLayout* weekLayout = new QHBoxLayout();
+    weekLayout->addWidget(new QLabel("轮换周数:"));
+    QSpinBox* weekSpin = new QSpinBox(&dialog);
+    weekSpin->setRange(2, 30);
+    weekSpin->setValue(rotationPlans.isEmpty() ? 4 : rotationPlans.size());
+    weekLayout->addWidget(weekSpin);
+    QPushButton* planBtn = new QPushButton("生成轮换计划", &dialog);
+    weekLayout->addWidget(planBtn);
+    layout->addLayout(weekLayout);
+
+    // 查看某一周的分组
+    QHBoxLayout* viewLayout = new QHBoxLayout();
+    viewLayout->addWidget(new QLabel("显示:"));
+    QComboBox* weekCombo = new QComboBox(&dialog);
+    viewLayout->addWidget(weekCombo);
+    QPushButton* exportAllBtn = new QPushButton("导出全部周", &dialog);
+    viewLayout->addWidget(exportAllBtn);
+    layout->addLayout(viewLayout);
+
+    auto refreshWeeks = [&]() {
+        weekCombo->blockSignals(true);
+        weekCombo->clear();
+        for (int w = 0; w < rotationPlans.size(); w++) {
+            weekCombo->addItem(QString("第%1周").arg(w + 1), w);
+        }
+        weekCombo->blockSignals(false);
+        exportAllBtn->setEnabled(!rotationPlans.isEmpty());
+        };
+    refreshWeeks();
+
+    QPushButton* closeBtn = new QPushButton("关闭", &dialog);
+    layout->addWidget(closeBtn, 0, Qt::AlignRight);
+
+    connect(planBtn, &QPushButton::clicked, [&]() {
+        generateRotationPlan(weekSpin->value());
+        refreshWeeks();
+        });
+
+    connect(weekCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), [&](int index) {
+        if (index < 0 || index >= rotationPlans.size()) return;
+        groups = rotationPlans[index];
+        examMode = false;
+        printGroups();
+        });
+
+    connect(exportAllBtn, &QPushButton::clicked, [&]() {
+        QString dir = QFileDialog::getExistingDirectory(&dialog, "选择导出目录");
+        if (dir.isEmpty()) return;
+
+        QVector<QVector<int>> current = groups;
+        QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
+        for (int w = 0; w < rotationPlans.size(); w++) {
+            groups = rotationPlans[w];
+            doExportSeatingPlan(QString("%1/%2_第%3周_座位表.xlsx").arg(dir, stamp).arg(w + 1));
+        }
+        groups = current;
+        });
+
+    connect(closeBtn, &QPushButton::clicked, &dialog, &QDialog::accept);
+
+    dialog.exec();
+}
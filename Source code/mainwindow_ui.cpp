@@ -30,7 +30,9 @@
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent), rng(static_cast<unsigned int>(time(nullptr))),
-    fileMenu(nullptr), mainLayout(nullptr), networkManager(nullptr), isCheckingUpdates(false)
+    fileMenu(nullptr), mainLayout(nullptr), networkManager(nullptr), isCheckingUpdates(false),
+    examMode(false), examRows(30), examCols(50), examEightNeighbors(false), lastSeed(0),
+    sameGenderDraws(0), solveSnapshotVersion(0)
 {
     setWindowIcon(QIcon(":/icons/app_icon.ico"));
     setWindowTitle("智能分组系统");
@@ -49,17 +51,37 @@ MainWindow::MainWindow(QWidget* parent)
     // 分组表格
     QGroupBox* groupBox = new QGroupBox("分组结果", this);
     QVBoxLayout* groupLayout = new QVBoxLayout(groupBox);
-    groupTable = new QTableWidget(this);
-    groupTable->setColumnCount(7);
-    groupTable->setHorizontalHeaderLabels(QStringList{ "组号", "成员1", "成员2", "成员3", "成员4", "成员5", "成员6" });
+    groupModel = new GroupTableModel(this);
+    groupTable = new QTableView(this);
+    groupTable->setModel(groupModel);
     groupTable->verticalHeader()->setVisible(false);
     groupTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    groupTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    groupTable->setSelectionBehavior(QAbstractItemView::SelectItems);
+    groupTable->setSelectionMode(QAbstractItemView::SingleSelection);
+
+    // 拖动单元格中的人到另一个座位，悬停提示由 eventFilter 显示在状态栏
+    groupModel->setMovesEnabled(true);
+    groupTable->setDragDropMode(QAbstractItemView::DragDrop);
+    groupTable->setDefaultDropAction(Qt::CopyAction);
+    groupTable->viewport()->installEventFilter(this);
+    groupTable->setContextMenuPolicy(Qt::CustomContextMenu);
+    groupTableContextMenu = new QMenu(this);
+    moveToSeatAction = groupTableContextMenu->addAction("移动到...");
+    suggestSwapAction = groupTableContextMenu->addAction("推荐交换...");
+    selectedPersonId = 0;
+    selectedGroup = -1;
+    selectedSeat = -1;
 
     // 设置所有列等宽
     groupTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
 
-    groupLayout->addWidget(groupTable);
+    // 座位图与表格显示同一份分组，分两个标签页
+    seatMap = new SeatMapWidget(this);
+    QTabWidget* resultTabs = new QTabWidget(groupBox);
+    resultTabs->addTab(groupTable, "表格");
+    resultTabs->addTab(seatMap, "座位图");
+
+    groupLayout->addWidget(resultTabs);
     topLayout->addWidget(groupBox, 2);
 
     // 系统日志
@@ -78,8 +100,18 @@ MainWindow::MainWindow(QWidget* parent)
     personnelCheckBtn = new QPushButton("人员检查", this);
     checkBtn = new QPushButton("要求检查", this);
     resetBtn = new QPushButton("重置", this);
+    reseatBtn = new QPushButton("最小变动调整", this);
+    reseatMetricCombo = new QComboBox(this);
+    reseatMetricCombo->addItem("最少移动人数", false);
+    reseatMetricCombo->addItem("最短移动距离", true);
+    stopSolveBtn = new QPushButton("停止优化", this);
+    stopSolveBtn->setToolTip("停止后台优化并保留当前最好的分组结果");
+    stopSolveBtn->setEnabled(false);
 
     buttonLayout->addWidget(generateBtn);
+    buttonLayout->addWidget(stopSolveBtn);
+    buttonLayout->addWidget(reseatBtn);
+    buttonLayout->addWidget(reseatMetricCombo);
     buttonLayout->addWidget(personnelCheckBtn);
     buttonLayout->addWidget(checkBtn);
     buttonLayout->addWidget(resetBtn);
@@ -136,7 +168,51 @@ MainWindow::MainWindow(QWidget* parent)
     connect(personnelCheckBtn, &QPushButton::clicked, this, &MainWindow::checkPersonnel);
     connect(checkBtn, &QPushButton::clicked, this, &MainWindow::checkConstraints);
     connect(resetBtn, &QPushButton::clicked, this, &MainWindow::resetAll);
-    connect(groupTable, &QTableWidget::cellClicked, this, &MainWindow::showGroupDetails);
+    connect(reseatBtn, &QPushButton::clicked, this, &MainWindow::minimalDisruptionReseat);
+    connect(stopSolveBtn, &QPushButton::clicked, this, &MainWindow::stopBackgroundSolve);
+
+    // 后台求解时每秒最多刷新几次表格
+    solveRefreshTimer = new QTimer(this);
+    solveRefreshTimer->setInterval(300);
+    connect(solveRefreshTimer, &QTimer::timeout, this, &MainWindow::refreshBackgroundSolve);
+    connect(groupTable, &QTableView::clicked, this, [this](const QModelIndex& index) {
+        // 右键选择"移动到..."后，下一次点击的单元格是目标座位
+        if (selectedPersonId != 0 && index.column() > 0) {
+            int person = selectedPersonId;
+            selectedPersonId = 0;
+            requestManualMove(person, index.row(), index.column() - 1);
+            return;
+        }
+        showGroupDetails(index.row(), index.column());
+        });
+    connect(groupTable, &QTableView::customContextMenuRequested, this, [this](const QPoint& pos) {
+        QModelIndex index = groupTable->indexAt(pos);
+        int person = groupModel->personAt(index);
+        if (person == 0 || examMode) return;
+        selectedPersonId = 0;
+        QPoint globalPos = groupTable->viewport()->mapToGlobal(pos);
+        QAction* chosen = groupTableContextMenu->exec(globalPos);
+        if (chosen == suggestSwapAction) {
+            showSwapSuggestions(person, globalPos);
+            return;
+        }
+        if (chosen != moveToSeatAction) return;
+        selectedPersonId = person;
+        selectedGroup = index.row();
+        selectedSeat = index.column() - 1;
+        updateStatus(QString("请点击 %1（组%2位置%3）的目标座位")
+            .arg(id_to_name.value(person)).arg(selectedGroup + 1).arg(selectedSeat + 1));
+        });
+    connect(groupModel, &GroupTableModel::moveRequested, this, &MainWindow::requestManualMove, Qt::QueuedConnection);
+    connect(seatMap, &SeatMapWidget::moveRequested, this, &MainWindow::requestManualMove);
+    connect(seatMap, &SeatMapWidget::dragStarted, this, [this]() {
+        prepareManualMove();
+        });
+    connect(seatMap, &SeatMapWidget::moveHovered, this, [this](int personId, int targetGroup, int targetSeat) {
+        ManualMove move = planManualMove(personId, targetGroup, targetSeat);
+        seatMap->setMoveFeedback(describeManualMove(move),
+            move.allowed && move.broken.isEmpty() && move.warnings.isEmpty() && move.penaltyDelta <= 0);
+        });
 
     // 创建菜单栏
     createMenuBar();
@@ -189,10 +265,50 @@ void MainWindow::createMenuBar()
     fileMenu->addSeparator();
     fileMenu->addAction(exitAction);
 
+    // 添加编辑菜单：手动调整的撤销/重做
+    QMenu* editMenu = menuBar->addMenu("编辑");
+    undoAction = editMenu->addAction("撤销");
+    undoAction->setShortcut(QKeySequence::Undo);
+    redoAction = editMenu->addAction("重做");
+    redoAction->setShortcut(QKeySequence::Redo);
+    editMenu->addSeparator();
+    editHistoryMenu = editMenu->addMenu("调整记录");
+    connect(undoAction, &QAction::triggered, this, &MainWindow::undoEdit);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::redoEdit);
+    // 调整记录在打开时才列出：第0项是第一次调整之前，当前所在的一项打勾，点击跳到该步
+    connect(editHistoryMenu, &QMenu::aboutToShow, this, [this]() {
+        editHistoryMenu->clear();
+        for (int step = 0; step <= editHistory.stepCount(); step++) {
+            QString text = step == 0 ? "调整之前" : QString("%1. %2").arg(step).arg(editHistory.stepLabel(step - 1));
+            QAction* action = editHistoryMenu->addAction(text);
+            action->setCheckable(true);
+            action->setChecked(step == editHistory.currentStep());
+            connect(action, &QAction::triggered, this, [this, step]() {
+                jumpToEdit(step);
+                });
+        }
+        });
+    updateEditActions();
+
     // 添加设置菜单项
     QAction* settingsAction = new QAction("设置", this);
     menuBar->addAction(settingsAction);
 
+    // 添加考场模式菜单项
+    QAction* examAction = new QAction("考场模式", this);
+    menuBar->addAction(examAction);
+
+    // 添加轮换计划菜单项
+    QAction* rotationAction = new QAction("轮换计划", this);
+    menuBar->addAction(rotationAction);
+
+    // 添加分组历史菜单项
+    QAction* historyAction = new QAction("分组历史", this);
+    menuBar->addAction(historyAction);
+
+    // 这些入口会改动分组或设置，后台求解期间禁用
+    solveLockedActions = { newFileAction, settingsAction, examAction, rotationAction, historyAction };
+
     // 添加帮助菜单
     QMenu* helpMenu = menuBar->addMenu("帮助");
 
@@ -211,6 +327,9 @@ void MainWindow::createMenuBar()
 
     // 连接其他菜单的信号槽
     connect(settingsAction, &QAction::triggered, this, &MainWindow::showSettingsDialog);
+    connect(examAction, &QAction::triggered, this, &MainWindow::showExamDialog);
+    connect(rotationAction, &QAction::triggered, this, &MainWindow::showRotationDialog);
+    connect(historyAction, &QAction::triggered, this, &MainWindow::showHistoryDialog);
     connect(checkUpdateAction, &QAction::triggered, this, [this]() {
         checkForUpdates(false);
         });
@@ -221,6 +340,7 @@ void MainWindow::createMenuBar()
 
 void MainWindow::showSettingsDialog()
 {
+    abortBackgroundSolve();
     QDialog dialog(this);
     dialog.setWindowTitle("设置");
     dialog.resize(600, 500);
@@ -299,7 +419,7 @@ void MainWindow::showSettingsDialog()
     QVector<QSpinBox*> maleSpins;
     QVector<QSpinBox*> femaleSpins;
 
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < groupConfigs.size(); i++) {
         int row = i + 1;
 
         // 组号标签
@@ -549,6 +669,7 @@ void MainWindow::showSettingsDialog()
 
         // 添加到固定位置映射
         fixedPositions[personId] = FixedPosition{ group, seat };
+        invalidateProblemModel();
 
         // 更新表格
         updateFixedPositionTable(fixedPositionTableLocal);
@@ -582,6 +703,7 @@ void MainWindow::showSettingsDialog()
         for (int id : idsToRemove) {
             fixedPositions.remove(id);
         }
+        invalidateProblemModel();
 
         updateFixedPositionTable(fixedPositionTableLocal);
         });
@@ -589,12 +711,41 @@ void MainWindow::showSettingsDialog()
     connect(clearFixedPositionsBtn, &QPushButton::clicked, [&]() {
         if (QMessageBox::question(&dialog, "确认", "确定要清空所有固定位置吗?") == QMessageBox::Yes) {
             fixedPositions.clear();
+            invalidateProblemModel();
             updateFixedPositionTable(fixedPositionTableLocal);
         }
         });
 
     // ====================== 保存按钮逻辑 ======================
     connect(saveButton, &QPushButton::clicked, [&]() {
+        // 记录名单变动前的分组、要求条件和固定位置（按姓名），用于增量调整
+        QStringList previousRoster = male_names + female_names;
+        QVector<QStringList> previousGroupNames;
+        for (const auto& group : groups) {
+            QStringList names;
+            for (int id : group) {
+                names.append(id_to_name.value(id));
+            }
+            previousGroupNames.append(names);
+        }
+        auto idsToNames = [this](const QVector<QVector<int>>& sets) {
+            QVector<QStringList> result;
+            for (const auto& set : sets) {
+                QStringList names;
+                for (int id : set) {
+                    names.append(id_to_name.value(id));
+                }
+                result.append(names);
+            }
+            return result;
+            };
+        QVector<QStringList> previousTogether = idsToNames(must_together_groups);
+        QVector<QStringList> previousSeparate = idsToNames(must_separate_groups);
+        QMap<QString, FixedPosition> previousFixed;
+        for (auto it = fixedPositions.begin(); it != fixedPositions.end(); ++it) {
+            previousFixed[id_to_name.value(it.key())] = it.value();
+        }
+
         // 保存人员名单
         male_names = maleEdit.toPlainText().split("\n", Qt::SkipEmptyParts);
         female_names = femaleEdit.toPlainText().split("\n", Qt::SkipEmptyParts);
@@ -607,7 +758,7 @@ void MainWindow::showSettingsDialog()
         boarders = QSet<QString>(boardersList.begin(), boardersList.end());
 
         // 保存分组配置
-        for (int i = 0; i < 10; i++) {
+        for (int i = 0; i < groupConfigs.size(); i++) {
             groupConfigs[i].enabled = enableCombos[i]->currentData().toBool();
             groupConfigs[i].total = totalSpins[i]->value();
             groupConfigs[i].males = maleSpins[i]->value();
@@ -615,10 +766,8 @@ void MainWindow::showSettingsDialog()
         }
 
         // 计算实际启用的组数
-        actualGroupCount = 0;
-        for (int i = 0; i < 10; i++) {
-            if (groupConfigs[i].enabled) actualGroupCount++;
-        }
+        invalidateProblemModel();
+        actualGroupCount = compileProblemModel()->groupCount;
 
         // 保存样式设置
         QString selectedStyle = styleCombo->currentData().toString();
@@ -645,6 +794,37 @@ void MainWindow::showSettingsDialog()
 
         dialog.accept();
 
+        // 名单变动且已有分组时，可只修复受影响的组
+        bool rosterChanged = previousRoster != male_names + female_names;
+        if (rosterChanged && !previousGroupNames.isEmpty() && !examMode &&
+            QMessageBox::question(this, "名单变动", "名单有变动，是否在当前分组基础上增量调整？\n选择\"否\"将清空当前分组。") == QMessageBox::Yes) {
+            // 按姓名重新映射要求条件和固定位置，已离开的人员从中移除
+            auto namesToIds = [this](const QVector<QStringList>& sets) {
+                QVector<QVector<int>> result;
+                for (const QStringList& names : sets) {
+                    QVector<int> ids;
+                    for (const QString& name : names) {
+                        if (name_to_id.contains(name)) ids.append(name_to_id.value(name));
+                    }
+                    if (ids.size() >= 2) result.append(ids);
+                }
+                return result;
+                };
+            must_together_groups = namesToIds(previousTogether);
+            must_separate_groups = namesToIds(previousSeparate);
+            fixedPositions.clear();
+            for (auto it = previousFixed.begin(); it != previousFixed.end(); ++it) {
+                if (name_to_id.contains(it.key())) fixedPositions[name_to_id.value(it.key())] = it.value();
+            }
+            invalidateProblemModel();
+            saveSettings();
+            updateConstraintTable();
+
+            if (incrementalResolve(previousGroupNames)) {
+                return;
+            }
+        }
+
         // 重置分组数据
         resetAll();
 
@@ -736,98 +916,71 @@ void MainWindow::showAboutDialog()
 
 void MainWindow::printGroups()
 {
-    // 确定启用的组
-    QVector<int> enabledGroups;
-    for (int i = 0; i < 10; i++) {
-        if (groupConfigs[i].enabled) {
-            enabledGroups.append(i);
-        }
+    // 考场模式按排显示
+    if (examMode) {
+        printExamGrid();
+        return;
     }
 
+    // 确定启用的组
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    const QVector<int>& enabledGroups = model->enabledGroups;
+
     if (enabledGroups.isEmpty()) {
-        groupTable->setRowCount(0);
+        groupModel->clear();
+        seatMap->setGroups({}, {});
         return;
     }
 
-    // 计算最大列数
-    int maxColumns = 11; // 组号列
-    for (int group_idx : enabledGroups) {
-        if (groupConfigs[group_idx].total + 1 > maxColumns) {
-            maxColumns = groupConfigs[group_idx].total + 1;
-        }
+    // 计算最大座位列数
+    int seatColumns = 10;
+    for (int capacity : model->capacity) {
+        seatColumns = qMax(seatColumns, capacity);
     }
 
-    // 设置表格结构
-    groupTable->setRowCount(enabledGroups.size());
-    groupTable->setColumnCount(maxColumns);
-
-    // 设置表头
-    QStringList headers;
-    headers << "组号";
-    for (int i = 1; i < maxColumns; i++) {
-        headers << QString("成员%1").arg(i);
+    // 完整组号显示
+    QStringList rowLabels;
+    for (int group_idx : enabledGroups) {
+        rowLabels << QString("组 %1").arg(group_idx + 1);
     }
-    groupTable->setHorizontalHeaderLabels(headers);
-
-    // 填充表格
-    for (int i = 0; i < enabledGroups.size(); i++) {
-        int group_idx = enabledGroups[i];
-        GroupConfig config = groupConfigs[group_idx];
-
-        // 完整组号显示
-        QTableWidgetItem* groupItem = new QTableWidgetItem(QString("组 %1").arg(group_idx + 1));
-        groupTable->setItem(i, 0, groupItem);
 
-        // 成员单元格
-        for (int j = 0; j < groups[i].size() && j < maxColumns - 1; j++) {
-            QString name = id_to_name[groups[i][j]];
-            QTableWidgetItem* item = new QTableWidgetItem(name);
-
-            // 设置性别背景色
-            if (getGender(groups[i][j]) == 'M') {
-                item->setBackground(QColor(200, 230, 255));
-            }
-            else {
-                item->setBackground(QColor(255, 230, 255));
-            }
-
-            // 标记组长
-            if (leaders.contains(name)) {
-                QFont font = item->font();
-                font.setBold(true);
-                item->setFont(font);
-            }
-
-            // 标记外宿生
-            if (boarders.contains(name)) {
-                item->setBackground(Qt::yellow);
-            }
+    // 模型只对变化的单元格通知视图，颜色、粗体由模型按人员属性计算
+    groupModel->setPeople(personDisplays(false));
+    groupModel->setAssignment(rowLabels, "组号", "成员", seatColumns, groups);
+    seatMap->setPeople(personDisplays(false));
+    seatMap->setGroups(rowLabels, groups);
+}
 
-            groupTable->setItem(i, j + 1, item);
+// 表格显示用的人员属性：性别背景色，组长粗体，外宿生黄色背景；考场模式改为在名字下方显示属性
+QVector<PersonDisplay> MainWindow::personDisplays(bool examNotes)
+{
+    int personCount = male_names.size() + female_names.size();
+    QVector<PersonDisplay> people(personCount + 1);
+    for (int id = 1; id <= personCount; id++) {
+        PersonDisplay& display = people[id];
+        display.name = id_to_name.value(id);
+        display.male = getGender(id) == 'M';
+        if (examNotes) {
+            display.note = examAttributes.value(display.name);
         }
-
-        // 填充空单元格
-        for (int j = groups[i].size(); j < maxColumns - 1; j++) {
-            groupTable->setItem(i, j + 1, new QTableWidgetItem(""));
+        else {
+            display.leader = leaders.contains(display.name);
+            display.boarder = boarders.contains(display.name);
         }
     }
-
-    // 设置列宽自适应
-    groupTable->resizeColumnsToContents();
-    groupTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
-    for (int i = 1; i < maxColumns; i++) {
-        groupTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-    }
+    return people;
 }
 
 void MainWindow::showGroupDetails(int row, int column)
 {
+    if (examMode) return;
     if (row >= GROUP_COUNT || row < 0) return;
 
     QString details = QString("<b>组 %1 详情:</b><br>").arg(row + 1);
 
     int maleCount = 0, femaleCount = 0;
     for (int id : groups[row]) {
+        if (id == 0) continue;
         QString name = id_to_name[id];
         details += name + " ";
         if (getGender(id) == 'M') maleCount++;
@@ -835,12 +988,8 @@ void MainWindow::showGroupDetails(int row, int column)
     }
 
     // 确定启用的组
-    QVector<int> enabledGroups;
-    for (int i = 0; i < 10; i++) {
-        if (groupConfigs[i].enabled) {
-            enabledGroups.append(i);
-        }
-    }
+    std::shared_ptr<const ProblemModel> model = compileProblemModel();
+    const QVector<int>& enabledGroups = model->enabledGroups;
 
     if (row >= enabledGroups.size() || row < 0) return;
 
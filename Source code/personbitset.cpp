@@ -0,0 +1,69 @@
+#include "personbitset.h"
+#include <QtAlgorithms>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+namespace {
+
+// 4个64位字的按位与后求popcount：按半字节查表，再用 SAD 把字节计数累加到各64位通道
+inline __m256i popcountAnd256(const quint64* a, const quint64* b)
+{
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0f);
+
+    __m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+    __m256i lo = _mm256_and_si256(v, lowMask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+} // namespace
+#endif
+
+int PersonBitset::count() const
+{
+    int total = 0;
+    for (quint64 word : words) {
+        total += qPopulationCount(word);
+    }
+    return total;
+}
+
+int PersonBitset::countAnd(const PersonBitset& other) const
+{
+    const quint64* a = words.constData();
+    const quint64* b = other.words.constData();
+    int n = qMin(words.size(), other.words.size());
+    int i = 0;
+    int total = 0;
+
+#ifdef __AVX2__
+    if (n >= 4) {
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 4 <= n; i += 4) {
+            acc = _mm256_add_epi64(acc, popcountAnd256(a + i, b + i));
+        }
+        total += int(_mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+            _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+    }
+#endif
+
+    for (; i < n; i++) {
+        total += qPopulationCount(a[i] & b[i]);
+    }
+    return total;
+}
+
+bool PersonBitset::intersects(const PersonBitset& other) const
+{
+    int n = qMin(words.size(), other.words.size());
+    for (int i = 0; i < n; i++) {
+        if (words[i] & other.words[i]) return true;
+    }
+    return false;
+}
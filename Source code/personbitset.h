@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef PERSONBITSET_H
+#define PERSONBITSET_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 按人员ID编号的位集合，宽度在构造时按名单人数固定
+// 几百人的名单只占几个64位字，"某要求有几人在某组"只需一次按位与加上popcount
+class PersonBitset {
+public:
+    PersonBitset() {}
+    explicit PersonBitset(int personCount) : words((personCount + 64) / 64, 0) {}
+
+    void set(int id) { words[id >> 6] |= quint64(1) << (id & 63); }
+    void reset(int id) { words[id >> 6] &= ~(quint64(1) << (id & 63)); }
+    bool test(int id) const { return (words[id >> 6] >> (id & 63)) & 1; }
+    void clear() { words.fill(0); }
+
+    int count() const;
+
+    // 与另一集合交集的元素个数（两集合宽度须相同）
+    int countAnd(const PersonBitset& other) const;
+    bool intersects(const PersonBitset& other) const;
+
+private:
+    QVector<quint64> words;
+};
+
+#endif // PERSONBITSET_H
@@ -0,0 +1,234 @@
+#include "portfolio.h"
+#include "assignmentscore.h"
+#include "cyclicexchange.h"
+#include "groupkernels.h"
+#include "lnsengine.h"
+#include "counterrng.h"
+#include "solverarena.h"
+#include "taskpool.h"
+#include <QElapsedTimer>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// 模拟退火：随机交换不同组的两个同性别可移动人员，温度按已完成的迭代次数几何下降，
+// 结果只取决于种子和迭代次数；时限和取消只用来提前停止，此时 interrupted 置为 true。
+// 交换对象在另选的组内用 GroupKernel 挑选，常见的4、6、8人组走展开版本
+QVector<QVector<int>> annealGroups(std::shared_ptr<const ProblemModel> model, const QVector<QVector<int>>& groups,
+    int maxIterations, qint64 timeBudgetMs, const CancelToken& cancelToken, SolutionSnapshot* snapshot, quint64 seed,
+    bool& interrupted)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<QVector<int>> current = groups;
+    AssignmentScore score;
+    score.build(model, current);
+
+    // 本次退火的临时数组放在自己的 arena 上，结束时一次释放
+    SolverArena arena;
+    struct Seat { int group; int seat; };
+    ArenaVector<Seat> seatOf(model->personCount + 1, { -1, -1 }, arena.resource());
+    ArenaVector<int> males(arena.resource());
+    ArenaVector<int> females(arena.resource());
+    ArenaVector<int> partnerSeats(arena.resource());
+    for (int g = 0; g < current.size(); g++) {
+        for (int s = 0; s < current[g].size(); s++) {
+            int person = current[g][s];
+            if (person == 0) continue;
+            seatOf[person] = { g, s };
+            if (model->isFixed(person)) continue;
+            if (model->isMale(person)) males.push_back(person); else females.push_back(person);
+        }
+    }
+
+    QVector<QVector<int>> best = current;
+    int bestPenalty = score.total();
+
+    CounterRng rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double startTemperature = 5.0;
+    const double endTemperature = 0.05;
+    double temperature = startTemperature;
+
+    for (int iteration = 0; iteration < maxIterations && bestPenalty > 0; iteration++) {
+        if ((iteration & 255) == 0) {
+            if (timer.elapsed() >= timeBudgetMs || cancelToken.isCancelled()) {
+                interrupted = true;
+                break;
+            }
+            temperature = startTemperature * std::pow(endTemperature / startTemperature, double(iteration) / maxIterations);
+        }
+
+        const ArenaVector<int>& pool = (unit(rng) < 0.5 && males.size() >= 2) || females.size() < 2 ? males : females;
+        if (pool.size() < 2 || current.size() < 2) break;
+        int a = pool[std::uniform_int_distribution<int>(0, int(pool.size()) - 1)(rng)];
+
+        // 交换对象：随机另选一个组，从中与 a 同性别的可移动人员里任取一人
+        int other = std::uniform_int_distribution<int>(0, int(current.size()) - 2)(rng);
+        if (other >= seatOf[a].group) other++;
+        const QVector<int>& otherGroup = std::as_const(current)[other];
+        bool male = model->isMale(a);
+        auto isPartner = [&](int person) { return person != 0 && !model->isFixed(person) && model->isMale(person) == male; };
+        partnerSeats.resize(otherGroup.size());
+        int partnerCount = GroupKernel::collectSeats(otherGroup, isPartner, partnerSeats.data());
+        if (partnerCount == 0) continue;
+        int b = otherGroup[partnerSeats[std::uniform_int_distribution<int>(0, partnerCount - 1)(rng)]];
+
+        int delta = score.swapDelta(a, b);
+        if (delta > 0 && unit(rng) >= std::exp(-delta / temperature)) continue;
+
+        score.applySwap(a, b);
+        std::swap(seatOf[a], seatOf[b]);
+        current[seatOf[a].group][seatOf[a].seat] = a;
+        current[seatOf[b].group][seatOf[b].seat] = b;
+        if (score.total() < bestPenalty) {
+            bestPenalty = score.total();
+            best = current;
+            if (snapshot) snapshot->offer(best, bestPenalty);
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+SolverPortfolio::SolverPortfolio(std::shared_ptr<const ProblemModel> problem, quint64 seedValue)
+    : model(std::move(problem)), seed(seedValue)
+{
+}
+
+PortfolioResult SolverPortfolio::run(const QVector<QVector<int>>& groups, qint64 timeBudgetMs,
+    CancelToken* stopToken, SolutionSnapshot* snapshot)
+{
+    PortfolioResult result;
+    result.groups = groups;
+
+    AssignmentScore initialScore;
+    initialScore.build(model, groups);
+    result.initialPenalty = initialScore.total();
+    result.penalty = result.initialPenalty;
+    if (snapshot) snapshot->offer(groups, result.initialPenalty);
+    if (result.initialPenalty == 0 || model->groupCount < 2 || groups.size() != model->groupCount) {
+        return result;
+    }
+
+    // 各策略按迭代次数运行，结果只取决于种子；时限只作为取消，被时限打断时记入 interrupted
+    struct Strategy {
+        QString name;
+        std::function<QVector<QVector<int>>(const CancelToken&, quint64, bool&)> solve;
+    };
+    std::shared_ptr<const ProblemModel> problem = model;
+    const int lnsRounds = lnsIterations;
+    const int annealRounds = annealIterations;
+    const QVector<Strategy> strategies = {
+        { "大邻域搜索", [=](const CancelToken& token, quint64 streamSeed, bool& interrupted) {
+            LnsEngine engine(problem, streamSeed);
+            engine.cancelToken = &token;
+            engine.snapshot = snapshot;
+            LnsResult lns = engine.run(groups, timeBudgetMs, lnsRounds);
+            interrupted = lns.interrupted;
+            return lns.groups;
+            } },
+        { "模拟退火", [=](const CancelToken& token, quint64 streamSeed, bool& interrupted) {
+            return annealGroups(problem, groups, annealRounds, timeBudgetMs, token, snapshot, streamSeed, interrupted);
+            } },
+        { "循环交换+大邻域搜索", [=](const CancelToken& token, quint64 streamSeed, bool& interrupted) {
+            CyclicExchange exchange(problem, streamSeed);
+            exchange.cancelToken = &token;
+            exchange.snapshot = snapshot;
+            CyclicExchangeResult cycles = exchange.run(groups, timeBudgetMs);
+            LnsEngine engine(problem, CounterRng::streamKey(streamSeed, 1, RngPhase::Portfolio));
+            engine.cancelToken = &token;
+            engine.snapshot = snapshot;
+            LnsResult lns = engine.run(cycles.groups, timeBudgetMs, lnsRounds);
+            interrupted = cycles.interrupted || lns.interrupted;
+            return lns.groups;
+            } },
+    };
+
+    // 各策略的结果，由工作线程写入
+    struct Outcome {
+        QVector<QVector<int>> groups;
+        int penalty = -1;   // -1 表示尚未完成
+        bool interrupted = false;
+    };
+    std::vector<Outcome> outcomes(strategies.size());
+    CancelToken ownToken;
+    CancelToken& token = stopToken ? *stopToken : ownToken;
+    // 每个策略有自己的取消标记：找到零代价方案时只取消排在它后面的策略，
+    // 排在前面的继续运行到结束，这样采用哪个策略的结果与线程的完成顺序无关
+    std::vector<std::unique_ptr<CancelToken>> strategyTokens;
+    for (int i = 0; i < strategies.size(); i++) {
+        strategyTokens.push_back(std::make_unique<CancelToken>(&token));
+    }
+    std::mutex mutex;
+    std::condition_variable finished;
+    int solvedBy = -1;   // 得到零代价方案的策略中下标最小的
+
+    auto decided = [&]() {
+        int last = solvedBy >= 0 ? solvedBy : int(strategies.size()) - 1;
+        for (int i = 0; i <= last; i++) {
+            if (outcomes[i].penalty < 0) return false;
+        }
+        return true;
+        };
+
+    TaskPool::TaskGroup tasks;
+    for (int i = 0; i < strategies.size(); i++) {
+        quint64 streamSeed = CounterRng::streamKey(seed, quint64(i), RngPhase::Portfolio);
+        tasks.run([&, i, streamSeed]() {
+            bool interrupted = false;
+            QVector<QVector<int>> candidate = strategies[i].solve(*strategyTokens[i], streamSeed, interrupted);
+            AssignmentScore score;
+            score.build(model, candidate);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            outcomes[i].groups = candidate;
+            outcomes[i].penalty = score.total();
+            outcomes[i].interrupted = interrupted;
+            if (score.total() == 0 && (solvedBy < 0 || i < solvedBy)) {
+                solvedBy = i;
+                for (int j = i + 1; j < strategies.size(); j++) {
+                    strategyTokens[j]->cancel();
+                }
+            }
+            finished.notify_all();
+            });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait_for(lock, std::chrono::milliseconds(timeBudgetMs), decided);
+    }
+    token.cancel();
+    tasks.wait();
+
+    // 代价最低者胜出，相同时取下标小的；零代价策略之后的策略已被取消，不参与比较
+    int winner = solvedBy;
+    int compared = solvedBy >= 0 ? solvedBy : int(outcomes.size()) - 1;
+    for (int i = 0; i <= compared; i++) {
+        if (outcomes[i].interrupted) result.interrupted = true;
+    }
+    if (winner < 0) {
+        for (int i = 0; i < int(outcomes.size()); i++) {
+            if (outcomes[i].penalty < 0) continue;
+            if (winner < 0 || outcomes[i].penalty < outcomes[winner].penalty) winner = i;
+        }
+    }
+    if (winner >= 0 && outcomes[winner].penalty < result.penalty) {
+        result.groups = outcomes[winner].groups;
+        result.penalty = outcomes[winner].penalty;
+        result.winner = strategies[winner].name;
+    }
+    result.solved = solvedBy >= 0;
+    return result;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <QString>
+#include <QVector>
+#include <memory>
+#include "problemmodel.h"
+#include "canceltoken.h"
+#include "solutionsnapshot.h"
+
+struct PortfolioResult {
+    QVector<QVector<int>> groups;
+    int initialPenalty = 0;
+    int penalty = 0;
+    QString winner;        // 给出最终结果的策略
+    bool solved = false;   // 某个策略找到了零代价方案，排在它后面的策略被提前取消
+    bool interrupted = false; // 时限到达或被停止时仍有策略未完成，此时结果与线程调度有关，同一种子不一定能重现
+};
+
+// 求解组合：从同一个初始方案出发，同时运行几种不同的改进策略（大邻域搜索、模拟退火、
+// 循环交换接大邻域搜索）。各策略按迭代次数运行，随机数来自按种子和策略下标派生的独立序列，
+// 取代价最低的结果（相同时取排在前面的策略），所以没有被时限打断时同一种子总得到同一方案。
+// 某个策略找到零代价方案时取消排在它后面的策略。时限和 stopToken 只用于提前停止，
+// 发生时结果记为 interrupted。传入 snapshot 时各策略的每次改进都发布到其中
+class SolverPortfolio {
+public:
+    SolverPortfolio(std::shared_ptr<const ProblemModel> model, quint64 seed);
+
+    PortfolioResult run(const QVector<QVector<int>>& groups, qint64 timeBudgetMs,
+        CancelToken* stopToken = nullptr, SolutionSnapshot* snapshot = nullptr);
+
+    int lnsIterations = 500;          // 大邻域搜索的迭代次数（两个用到它的策略各自的上限）
+    int annealIterations = 1000000;   // 模拟退火的迭代次数，温度按此下降
+
+private:
+    std::shared_ptr<const ProblemModel> model;
+    quint64 seed;
+};
+
+#endif // PORTFOLIO_H
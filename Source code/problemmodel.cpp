@@ -0,0 +1,347 @@
+#include "problemmodel.h"
+#include <QtGlobal>
+#include <utility>
+
+namespace {
+
+// 将若干集合压缩为CSR格式，丢弃无效的人员ID
+void buildSets(const QVector<QVector<int>>& sets, int personCount, QVector<int>& offsets, QVector<int>& members)
+{
+    offsets.clear();
+    members.clear();
+    offsets.reserve(sets.size() + 1);
+    offsets.append(0);
+    // 同一要求里重复出现的人只保留一次，否则集合大小与位集合的人数对不上
+    QVector<int> seenIn(personCount + 1, -1);
+    for (int s = 0; s < sets.size(); s++) {
+        for (int person : sets[s]) {
+            if (person < 1 || person > personCount || seenIn[person] == s) continue;
+            seenIn[person] = s;
+            members.append(person);
+        }
+        offsets.append(members.size());
+    }
+}
+
+// 反向索引：人员ID -> 所属集合下标
+void buildPersonIndex(const QVector<int>& setOffsets, const QVector<int>& setMembers, int personCount,
+    QVector<int>& offsets, QVector<int>& entries)
+{
+    offsets = QVector<int>(personCount + 2, 0);
+    for (int person : setMembers) {
+        offsets[person + 1]++;
+    }
+    for (int id = 1; id <= personCount + 1; id++) {
+        offsets[id] += offsets[id - 1];
+    }
+
+    entries = QVector<int>(setMembers.size(), 0);
+    QVector<int> cursor = offsets;
+    for (int s = 0; s + 1 < setOffsets.size(); s++) {
+        for (int k = setOffsets[s]; k < setOffsets[s + 1]; k++) {
+            entries[cursor[setMembers[k]]++] = s;
+        }
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const ProblemModel> ProblemModel::compile(const ProblemInput& input)
+{
+    auto model = std::make_shared<ProblemModel>();
+    int personCount = input.maleCount + input.femaleCount;
+    model->personCount = personCount;
+    model->maleCount = input.maleCount;
+
+    // 启用的组
+    model->localIndex = QVector<int>(input.groupEnabled.size(), -1);
+    for (int i = 0; i < input.groupEnabled.size(); i++) {
+        if (!input.groupEnabled[i]) continue;
+        model->localIndex[i] = model->enabledGroups.size();
+        model->enabledGroups.append(i);
+        model->capacity.append(input.groupTotal.value(i));
+        model->quotaMales.append(input.groupMales.value(i, -1));
+        model->quotaFemales.append(input.groupFemales.value(i, -1));
+    }
+    model->groupCount = model->enabledGroups.size();
+
+    // 人员属性
+    model->flags = QVector<quint8>(personCount + 1, 0);
+    model->fixedGroupOf = QVector<int>(personCount + 1, -1);
+    model->fixedSeatOf = QVector<int>(personCount + 1, -1);
+    for (int id = 1; id <= personCount; id++) {
+        quint8 f = 0;
+        if (id <= input.maleCount) f |= MALE;
+        if (input.isLeader.value(id)) {
+            f |= LEADER;
+            model->leaderTotal++;
+        }
+        if (input.isBoarder.value(id)) {
+            f |= BOARDER;
+            model->boarderTotal++;
+        }
+        model->flags[id] = f;
+    }
+
+    for (auto it = input.fixedSeats.begin(); it != input.fixedSeats.end(); ++it) {
+        int id = it.key();
+        if (id < 1 || id > personCount) continue;
+        model->flags[id] |= FIXED;
+        model->fixedGroupOf[id] = model->localGroupOf(it.value().first - 1);
+        model->fixedSeatOf[id] = it.value().second - 1;
+    }
+
+    // 要求条件
+    buildSets(input.togetherSets, personCount, model->togetherOffsets, model->togetherMembers);
+    buildSets(input.separateSets, personCount, model->separateOffsets, model->separateMembers);
+    buildPersonIndex(model->togetherOffsets, model->togetherMembers, personCount,
+        model->personTogetherOffsets, model->personTogether);
+    buildPersonIndex(model->separateOffsets, model->separateMembers, personCount,
+        model->personSeparateOffsets, model->personSeparate);
+
+    model->buildMasks();
+    model->checkFeasibility(input);
+    model->buildClusters();
+    model->detectConflicts();
+
+    return model;
+}
+
+void ProblemModel::buildMasks()
+{
+    leaders = PersonBitset(personCount);
+    boarders = PersonBitset(personCount);
+    for (int id = 1; id <= personCount; id++) {
+        if (isLeader(id)) leaders.set(id);
+        if (isBoarder(id)) boarders.set(id);
+    }
+
+    auto masksOf = [this](const QVector<int>& offsets, const QVector<int>& members) {
+        QVector<PersonBitset> masks(offsets.size() - 1, PersonBitset(personCount));
+        for (int s = 0; s + 1 < offsets.size(); s++) {
+            for (int k = offsets[s]; k < offsets[s + 1]; k++) {
+                masks[s].set(members[k]);
+            }
+        }
+        return masks;
+        };
+    togetherMasks = masksOf(togetherOffsets, togetherMembers);
+    separateMasks = masksOf(separateOffsets, separateMembers);
+}
+
+void ProblemModel::checkFeasibility(const ProblemInput& input)
+{
+    // 座位总数
+    int seats = 0;
+    for (int g = 0; g < groupCount; g++) {
+        seats += capacity[g];
+    }
+    if (seats < personCount) {
+        conflictList.append({ ProblemConflict::SeatShortage, true, -1, 0, 0, -1, personCount, seats });
+    }
+
+    // 男女配额之和与人数不符只提示：配额不强制人数，多出的人坐到其他空位上，评分中计入超出配额的组。
+    // 只有单个组的配额之和超过该组座位数时才无论如何都无法满足
+    auto checkQuota = [&](const QVector<int>& quota, int people, ProblemConflict::Type type) {
+        int sum = 0;
+        bool allLimited = groupCount > 0;
+        for (int g = 0; g < groupCount; g++) {
+            if (quota[g] >= 0) sum += quota[g];
+            else allLimited = false;
+        }
+        if (sum > people || (allLimited && sum < people)) {
+            conflictList.append({ type, false, -1, 0, 0, -1, sum, people });
+        }
+        };
+    checkQuota(quotaMales, maleCount, ProblemConflict::MaleQuota);
+    checkQuota(quotaFemales, personCount - maleCount, ProblemConflict::FemaleQuota);
+
+    for (int g = 0; g < groupCount; g++) {
+        int quotaSum = qMax(quotaMales[g], 0) + qMax(quotaFemales[g], 0);
+        if (quotaSum > capacity[g]) {
+            conflictList.append({ ProblemConflict::GroupQuota, true, -1, 0, 0, g, quotaSum, capacity[g] });
+        }
+    }
+
+    // 组长人数与组数不符只提示：多出的组长按普通组员分配，评分中计入重复组长
+    if (leaderTotal > groupCount || (leaderTotal > 0 && leaderTotal < groupCount)) {
+        conflictList.append({ ProblemConflict::LeaderCount, false, -1, 0, 0, -1, leaderTotal, groupCount });
+    }
+
+    // 固定位置
+    QVector<int> seatOffsets(groupCount + 1, 0);
+    for (int g = 0; g < groupCount; g++) {
+        seatOffsets[g + 1] = seatOffsets[g] + capacity[g];
+    }
+    QVector<int> seatOwner(seatOffsets.last(), 0);
+    for (auto it = input.fixedSeats.begin(); it != input.fixedSeats.end(); ++it) {
+        int id = it.key();
+        if (id < 1 || id > personCount) continue;
+        int groupNumber = it.value().first;
+        int seat = it.value().second;
+        int g = fixedGroupOf[id];
+        if (g < 0) {
+            conflictList.append({ ProblemConflict::FixedGroupDisabled, true, -1, id, 0, -1, groupNumber, 0 });
+        }
+        else if (seat < 1 || seat > capacity[g]) {
+            conflictList.append({ ProblemConflict::FixedSeatRange, true, -1, id, 0, g, seat, capacity[g] });
+        }
+        else {
+            int& owner = seatOwner[seatOffsets[g] + seat - 1];
+            if (owner != 0) {
+                conflictList.append({ ProblemConflict::FixedSeatTaken, true, -1, owner, id, g, seat, 0 });
+            }
+            else {
+                owner = id;
+            }
+        }
+    }
+
+    // 不能同组：人数超过组数时必有两人同组
+    for (int s = 0; s < separateCount(); s++) {
+        IdRange set = separateSet(s);
+        if (set.size() > groupCount) {
+            conflictList.append({ ProblemConflict::SeparateTooLarge, true, s, set[0], 0, -1, set.size(), groupCount });
+        }
+    }
+}
+
+void ProblemModel::buildClusters()
+{
+    // 并查集（路径减半 + 按大小合并）
+    QVector<int> parent(personCount + 1, 0);
+    QVector<int> setSize(personCount + 1, 1);
+    for (int id = 0; id <= personCount; id++) {
+        parent[id] = id;
+    }
+    auto find = [&](int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+        };
+    auto unite = [&](int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (setSize[a] < setSize[b]) std::swap(a, b);
+        parent[b] = a;
+        setSize[a] += setSize[b];
+        };
+
+    for (int s = 0; s < togetherCount(); s++) {
+        IdRange set = togetherSet(s);
+        for (int k = 1; k < set.size(); k++) {
+            unite(set[0], set[k]);
+        }
+    }
+
+    // 按最小成员ID给集合编号，只保留至少两人的集合
+    clusterOfPerson = QVector<int>(personCount + 1, -1);
+    QVector<int> rootCluster(personCount + 1, -1);
+    QVector<int> sizes;
+    for (int id = 1; id <= personCount; id++) {
+        int root = find(id);
+        if (setSize[root] < 2) continue;
+        if (rootCluster[root] == -1) {
+            rootCluster[root] = sizes.size();
+            sizes.append(0);
+        }
+        clusterOfPerson[id] = rootCluster[root];
+        sizes[rootCluster[root]]++;
+    }
+
+    clusterOffsets = QVector<int>(sizes.size() + 1, 0);
+    for (int c = 0; c < sizes.size(); c++) {
+        clusterOffsets[c + 1] = clusterOffsets[c] + sizes[c];
+    }
+    clusterMembers = QVector<int>(clusterOffsets.last(), 0);
+    clusterMaleCount = QVector<int>(sizes.size(), 0);
+    clusterFixedGroup = QVector<int>(sizes.size(), -1);
+
+    QVector<int> cursor = clusterOffsets;
+    for (int id = 1; id <= personCount; id++) {
+        int c = clusterOfPerson[id];
+        if (c < 0) continue;
+        clusterMembers[cursor[c]++] = id;
+        if (isMale(id)) clusterMaleCount[c]++;
+        if (clusterFixedGroup[c] == -1 && fixedGroupOf[id] >= 0) clusterFixedGroup[c] = fixedGroupOf[id];
+    }
+}
+
+bool ProblemModel::clusterFits(int c, int g) const
+{
+    int size = cluster(c).size();
+    int males = clusterMaleCount[c];
+    int females = size - males;
+    return size <= capacity[g] &&
+        (quotaMales[g] < 0 || males <= quotaMales[g]) &&
+        (quotaFemales[g] < 0 || females <= quotaFemales[g]);
+}
+
+bool ProblemModel::hasFatalConflict() const
+{
+    for (const ProblemConflict& conflict : conflictList) {
+        if (conflict.fatal) return true;
+    }
+    return false;
+}
+
+void ProblemModel::detectConflicts()
+{
+    for (int c = 0; c < clusterCount(); c++) {
+        IdRange members = cluster(c);
+
+        // 座位数和配额
+        bool anySeats = false;
+        bool anyFit = false;
+        for (int g = 0; g < groupCount; g++) {
+            if (members.size() <= capacity[g]) anySeats = true;
+            if (clusterFits(c, g)) anyFit = true;
+        }
+        if (!anySeats) {
+            conflictList.append({ ProblemConflict::ClusterTooLarge, true, c, members[0], 0, -1 });
+        }
+        else if (!anyFit) {
+            conflictList.append({ ProblemConflict::ClusterQuota, false, c, members[0], 0, -1 });
+        }
+
+        // 固定位置
+        int anchor = 0;
+        for (int person : members) {
+            int fg = fixedGroupOf[person];
+            if (fg < 0) continue;
+            if (anchor == 0) {
+                anchor = person;
+            }
+            else if (fg != fixedGroupOf[anchor]) {
+                conflictList.append({ ProblemConflict::FixedSplit, true, c, anchor, person, fixedGroupOf[anchor] });
+            }
+        }
+        int pinned = clusterFixedGroup[c];
+        if (pinned >= 0 && members.size() > capacity[pinned]) {
+            conflictList.append({ ProblemConflict::FixedGroupTooSmall, true, c, anchor, 0, pinned });
+        }
+    }
+
+    // 同一合并集合中的两人出现在同一个不能同组要求中
+    QVector<int> firstInCluster(clusterCount(), 0);
+    for (int s = 0; s < separateCount(); s++) {
+        IdRange set = separateSet(s);
+        for (int person : set) {
+            int c = clusterOfPerson[person];
+            if (c < 0) continue;
+            if (firstInCluster[c] == 0) {
+                firstInCluster[c] = person;
+            }
+            else if (firstInCluster[c] != person) {
+                conflictList.append({ ProblemConflict::TogetherSeparate, true, c, firstInCluster[c], person, -1 });
+            }
+        }
+        for (int person : set) {
+            int c = clusterOfPerson[person];
+            if (c >= 0) firstInCluster[c] = 0;
+        }
+    }
+}
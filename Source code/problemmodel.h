@@ -0,0 +1,186 @@
+#pragma once
+
+#ifndef PROBLEMMODEL_H
+#define PROBLEMMODEL_H
+
+#include <QVector>
+#include <QMap>
+#include <memory>
+#include "personbitset.h"
+
+// 编译前的原始输入，由 MainWindow 从当前名单、分组配置和要求条件填写
+struct ProblemInput {
+    int maleCount = 0;
+    int femaleCount = 0;
+    QVector<bool> groupEnabled;          // 下标为组配置下标（0-9）
+    QVector<int> groupTotal;
+    QVector<int> groupMales;
+    QVector<int> groupFemales;
+    QVector<bool> isLeader;              // 下标为人员ID（0 不使用）
+    QVector<bool> isBoarder;
+    QMap<int, QPair<int, int>> fixedSeats; // 人员ID -> (组号, 座位号)，均从1开始
+    QVector<QVector<int>> togetherSets;
+    QVector<QVector<int>> separateSets;
+};
+
+// 连续存储中的一段人员ID或要求下标
+struct IdRange {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    int size() const { return int(last - first); }
+    bool isEmpty() const { return first == last; }
+    int operator[](int i) const { return first[i]; }
+    bool contains(int id) const {
+        for (const int* p = first; p != last; ++p) {
+            if (*p == id) return true;
+        }
+        return false;
+    }
+};
+
+// 编译时发现的配置或要求矛盾，人员用ID表示，由调用方转换为姓名显示
+struct ProblemConflict {
+    enum Type {
+        SeatShortage,      // 启用组的座位总数少于人数
+        MaleQuota,         // 男生配额之和与男生人数不符
+        FemaleQuota,       // 女生配额之和与女生人数不符
+        GroupQuota,        // 某组男女配额之和超过该组座位数
+        LeaderCount,       // 组长人数与组数不符
+        FixedGroupDisabled,// 固定位置所在的组未启用
+        FixedSeatRange,    // 固定位置的座位号超出该组座位数
+        FixedSeatTaken,    // 两人被固定在同一个座位
+        SeparateTooLarge,  // 不能同组要求的人数超过组数
+        ClusterTooLarge,   // 合并后的同组集合超过所有组的座位数
+        ClusterQuota,      // 合并后的同组集合男生或女生人数超过所有组的配额
+        TogetherSeparate,  // 同一同组集合中的两人又被要求不能同组
+        FixedSplit,        // 同一同组集合中的两人被固定在不同的组
+        FixedGroupTooSmall // 同组集合被固定位置限定在某组，但该组放不下
+    };
+
+    Type type;
+    bool fatal;          // 为 true 时无论如何都无法满足
+    int cluster = -1;    // 合并集合下标（SeparateTooLarge 时为不能同组要求下标）
+    int personA = 0;
+    int personB = 0;
+    int group = -1;      // 本地组下标
+    int value = 0;       // 实际数量，如人数、配额之和、座位号
+    int limit = 0;       // 允许的数量
+};
+
+// 编译后的只读问题模型
+// 名单和要求在求解前一次性转换为连续数组：人员属性按ID紧凑存放，要求条件按CSR格式存放，
+// 启用组的映射和配额预先算好。构建后不再修改，多个工作线程和多次求解可通过
+// std::shared_ptr<const ProblemModel> 无锁共享
+class ProblemModel {
+public:
+    static std::shared_ptr<const ProblemModel> compile(const ProblemInput& input);
+
+    // 人员，ID 为 1..personCount，男生在前
+    int personCount = 0;
+    int maleCount = 0;
+
+    bool isMale(int id) const { return flags[id] & MALE; }
+    bool isLeader(int id) const { return flags[id] & LEADER; }
+    bool isBoarder(int id) const { return flags[id] & BOARDER; }
+    bool isFixed(int id) const { return flags[id] & FIXED; }
+    int fixedGroup(int id) const { return fixedGroupOf[id]; } // 本地组下标，未固定或组未启用为 -1
+    int fixedSeat(int id) const { return fixedSeatOf[id]; }   // 从0开始
+
+    int leaderTotal = 0;
+    int boarderTotal = 0;
+
+    // 启用的组，本地下标 0..groupCount-1
+    int groupCount = 0;
+    QVector<int> enabledGroups;   // 本地下标 -> 组配置下标（0-9）
+    QVector<int> capacity;        // 每组座位数
+    QVector<int> quotaMales;      // 每组男生配额，-1 表示不限
+    QVector<int> quotaFemales;    // 每组女生配额，-1 表示不限
+
+    // 组配置下标（0-9）-> 本地下标，未启用为 -1
+    int localGroupOf(int configIndex) const {
+        return configIndex >= 0 && configIndex < localIndex.size() ? localIndex[configIndex] : -1;
+    }
+    int groupNumber(int localGroup) const { return enabledGroups[localGroup] + 1; }
+
+    // 要求条件
+    int togetherCount() const { return togetherOffsets.size() - 1; }
+    int separateCount() const { return separateOffsets.size() - 1; }
+    IdRange togetherSet(int s) const { return range(togetherMembers, togetherOffsets, s); }
+    IdRange separateSet(int s) const { return range(separateMembers, separateOffsets, s); }
+
+    // 人员所属的要求下标
+    IdRange togetherSetsOf(int id) const { return range(personTogether, personTogetherOffsets, id); }
+    IdRange separateSetsOf(int id) const { return range(personSeparate, personSeparateOffsets, id); }
+
+    // 位集合形式的要求条件和组长、外宿生名单，宽度为 personCount + 1
+    const PersonBitset& togetherMask(int s) const { return togetherMasks[s]; }
+    const PersonBitset& separateMask(int s) const { return separateMasks[s]; }
+    const PersonBitset& leaderMask() const { return leaders; }
+    const PersonBitset& boarderMask() const { return boarders; }
+    PersonBitset emptyMask() const { return PersonBitset(personCount); }
+
+    // 合并后的必须同组集合：有共同成员的要求用并查集合并为一个集合，成员按ID排序
+    int clusterCount() const { return clusterOffsets.size() - 1; }
+    IdRange cluster(int c) const { return range(clusterMembers, clusterOffsets, c); }
+    int clusterOf(int id) const { return clusterOfPerson[id]; } // 不属于任何集合为 -1
+    int clusterMales(int c) const { return clusterMaleCount[c]; }
+    int clusterGroup(int c) const { return clusterFixedGroup[c]; } // 由固定位置确定的本地组，未确定为 -1
+
+    // 合并后的集合能否整体放入某组（只看座位数和配额）
+    bool clusterFits(int c, int g) const;
+
+    // 编译时发现的矛盾（先做线性时间的容量、配额、固定位置检查，再检查合并后的同组集合），
+    // fatal 为 true 的矛盾存在时不应开始求解
+    const QVector<ProblemConflict>& conflicts() const { return conflictList; }
+    bool hasFatalConflict() const;
+
+private:
+    enum Flag : quint8 {
+        MALE = 1,
+        LEADER = 2,
+        BOARDER = 4,
+        FIXED = 8
+    };
+
+    static IdRange range(const QVector<int>& data, const QVector<int>& offsets, int i) {
+        const int* base = data.constData();
+        return IdRange{ base + offsets[i], base + offsets[i + 1] };
+    }
+
+    QVector<quint8> flags;
+    QVector<int> fixedGroupOf;
+    QVector<int> fixedSeatOf;
+    QVector<int> localIndex;
+
+    QVector<int> togetherOffsets;
+    QVector<int> togetherMembers;
+    QVector<int> separateOffsets;
+    QVector<int> separateMembers;
+    QVector<int> personTogetherOffsets;
+    QVector<int> personTogether;
+    QVector<int> personSeparateOffsets;
+    QVector<int> personSeparate;
+
+    QVector<PersonBitset> togetherMasks;
+    QVector<PersonBitset> separateMasks;
+    PersonBitset leaders;
+    PersonBitset boarders;
+
+    QVector<int> clusterOffsets;
+    QVector<int> clusterMembers;
+    QVector<int> clusterOfPerson;
+    QVector<int> clusterMaleCount;
+    QVector<int> clusterFixedGroup;
+
+    QVector<ProblemConflict> conflictList;
+
+    void buildMasks();
+    void checkFeasibility(const ProblemInput& input);
+    void buildClusters();
+    void detectConflicts();
+};
+
+#endif // PROBLEMMODEL_H
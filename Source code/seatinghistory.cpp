@@ -0,0 +1,247 @@
+#include "seatinghistory.h"
+#include <QFile>
+#include <QDataStream>
+#include <QIODevice>
+#include <QLockFile>
+
+namespace {
+const quint32 RECORD_MAGIC = 0x53454154; // "SEAT"
+const quint32 RECORD_VERSION = 1;
+const int MAX_GROUP_NUMBER = 10;
+const int LOCK_TIMEOUT_MS = 2000;
+}
+
+bool SeatingHistory::open(const QString& filePath)
+{
+    path.clear();
+    clearIndex();
+
+    QFile file(filePath);
+    if (!file.exists()) {
+        path = filePath;
+        return true;
+    }
+
+    // 持有写入锁时没有其他实例正在写，扫描后剩下的不完整尾部只能是中断的写入留下的
+    QLockFile lock(filePath + ".lock");
+    bool locked = lock.tryLock(LOCK_TIMEOUT_MS);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    scanRecords(file, 0);
+    qint64 fileSize = file.size();
+    file.close();
+
+    // 截掉损坏的尾部，否则之后追加的记录都排在它后面，再次打开时读不到
+    if (locked && validEnd < fileSize) {
+        QFile tail(filePath);
+        if (tail.open(QIODevice::ReadWrite)) {
+            tail.resize(validEnd);
+        }
+    }
+
+    path = filePath;
+    return true;
+}
+
+bool SeatingHistory::append(const SeatingRecord& record)
+{
+    if (path.isEmpty()) {
+        return false;
+    }
+
+    QLockFile lock(path + ".lock");
+    if (!lock.tryLock(LOCK_TIMEOUT_MS)) {
+        return false;
+    }
+
+    // 先读入其他实例在上次读取之后追加的记录；文件比已读的部分还短说明被替换过，重新扫描
+    QFile file(path);
+    if (file.exists()) {
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        if (file.size() < validEnd) {
+            clearIndex();
+        }
+        if (file.size() > validEnd) {
+            scanRecords(file, validEnd);
+        }
+        bool clean = validEnd == file.size();
+        file.close();
+        // 末尾有无法读取的数据时不在其后写入，由下次 open 截掉
+        if (!clean) {
+            return false;
+        }
+    }
+    else {
+        clearIndex();
+    }
+
+    QByteArray frame;
+    QDataStream out(&frame, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << RECORD_MAGIC << encode(record);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    if (file.write(frame) != frame.size() || !file.flush()) {
+        return false;
+    }
+    file.close();
+
+    recordOffsets.append(validEnd);
+    validEnd += frame.size();
+    indexRecord(record);
+    return true;
+}
+
+void SeatingHistory::clearIndex()
+{
+    validEnd = 0;
+    recordOffsets.clear();
+    nameIds.clear();
+    pairCounts.clear();
+    lastInGroup.clear();
+}
+
+// 从 start 开始顺序读取记录建立索引，遇到不完整或无法识别的记录即停止
+void SeatingHistory::scanRecords(QFile& file, qint64 start)
+{
+    if (!file.seek(start)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    while (!in.atEnd()) {
+        qint64 offset = file.pos();
+        quint32 magic = 0;
+        QByteArray payload;
+        in >> magic >> payload;
+        if (in.status() != QDataStream::Ok || magic != RECORD_MAGIC) {
+            break;
+        }
+        validEnd = file.pos();
+
+        SeatingRecord record;
+        if (!decode(payload, record)) {
+            continue;
+        }
+        recordOffsets.append(offset);
+        indexRecord(record);
+    }
+}
+
+SeatingRecord SeatingHistory::readRecord(int index) const
+{
+    SeatingRecord record;
+    if (index < 0 || index >= recordOffsets.size()) {
+        return record;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(recordOffsets[index])) {
+        return record;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    QByteArray payload;
+    in >> magic >> payload;
+    if (magic == RECORD_MAGIC) {
+        decode(payload, record);
+    }
+    return record;
+}
+
+int SeatingHistory::pairCount(const QString& a, const QString& b) const
+{
+    int idA = nameIds.value(a, -1);
+    int idB = nameIds.value(b, -1);
+    if (idA < 0 || idB < 0 || idA == idB) {
+        return 0;
+    }
+    return pairCounts.value(pairKey(idA, idB), 0);
+}
+
+qint64 SeatingHistory::lastTimeInGroups(const QString& name, const QSet<int>& groupNumbers) const
+{
+    int id = nameIds.value(name, -1);
+    if (id < 0) {
+        return -1;
+    }
+
+    qint64 latest = -1;
+    for (int groupNumber : groupNumbers) {
+        if (groupNumber >= 1 && groupNumber <= MAX_GROUP_NUMBER) {
+            latest = qMax(latest, lastInGroup[id][groupNumber]);
+        }
+    }
+    return latest;
+}
+
+QByteArray SeatingHistory::encode(const SeatingRecord& record)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << RECORD_VERSION << record.timestamp << record.seed << record.label << record.config
+        << record.groupNumbers << record.groups;
+    return payload;
+}
+
+bool SeatingHistory::decode(const QByteArray& payload, SeatingRecord& record)
+{
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 version = 0;
+    in >> version;
+    if (version != RECORD_VERSION) {
+        return false;
+    }
+    in >> record.timestamp >> record.seed >> record.label >> record.config
+        >> record.groupNumbers >> record.groups;
+    return in.status() == QDataStream::Ok && record.groupNumbers.size() == record.groups.size();
+}
+
+int SeatingHistory::internName(const QString& name)
+{
+    auto it = nameIds.constFind(name);
+    if (it != nameIds.constEnd()) {
+        return it.value();
+    }
+
+    int id = nameIds.size();
+    nameIds.insert(name, id);
+    lastInGroup.append(QVector<qint64>(MAX_GROUP_NUMBER + 1, -1));
+    return id;
+}
+
+void SeatingHistory::indexRecord(const SeatingRecord& record)
+{
+    for (int i = 0; i < record.groups.size(); i++) {
+        const QStringList& members = record.groups[i];
+        int groupNumber = record.groupNumbers[i];
+
+        QVector<int> ids;
+        ids.reserve(members.size());
+        for (const QString& name : members) {
+            if (name.isEmpty()) continue;
+            int id = internName(name);
+            ids.append(id);
+            if (groupNumber >= 1 && groupNumber <= MAX_GROUP_NUMBER) {
+                qint64& last = lastInGroup[id][groupNumber];
+                last = qMax(last, record.timestamp);
+            }
+        }
+
+        for (int a = 0; a < ids.size(); a++) {
+            for (int b = a + 1; b < ids.size(); b++) {
+                pairCounts[pairKey(ids[a], ids[b])]++;
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef SEATINGHISTORY_H
+#define SEATINGHISTORY_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QByteArray>
+
+class QFile;
+
+// 一条分组历史记录：按姓名保存，名单变动后仍可查询
+struct SeatingRecord {
+    qint64 timestamp = 0;            // 毫秒时间戳
+    quint64 seed = 0;                // 生成该结果所用的随机种子
+    QString label;                   // 来源说明，如"生成分组"、"轮换第2周"
+    QByteArray config;               // 生成时的配置（JSON）
+    QVector<int> groupNumbers;       // 每个组对应的组号（1-10）
+    QVector<QStringList> groups;     // 每组成员姓名，按座位顺序
+};
+
+// 只追加的本地分组历史库
+// 文件为连续的长度前缀记录；打开时顺序扫描一次建立内存索引，之后的查询均为哈希查找。
+// 多个实例可以共用一个文件：写入时持有锁文件并只在末尾追加，追加前先读入其他实例新写的记录
+class SeatingHistory {
+public:
+    bool open(const QString& filePath);
+    bool append(const SeatingRecord& record);
+
+    int recordCount() const { return recordOffsets.size(); }
+    SeatingRecord readRecord(int index) const;
+
+    // A 和 B 曾经同组的次数
+    int pairCount(const QString& a, const QString& b) const;
+
+    // 某人最近一次位于给定组号之一的时间，从未出现返回 -1
+    qint64 lastTimeInGroups(const QString& name, const QSet<int>& groupNumbers) const;
+
+private:
+    static QByteArray encode(const SeatingRecord& record);
+    static bool decode(const QByteArray& payload, SeatingRecord& record);
+    void clearIndex();
+    void scanRecords(QFile& file, qint64 start);
+    void indexRecord(const SeatingRecord& record);
+    int internName(const QString& name);
+
+    static quint64 pairKey(int a, int b) {
+        return a < b ? (quint64(a) << 32) | quint32(b) : (quint64(b) << 32) | quint32(a);
+    }
+
+    QString path;
+    QVector<qint64> recordOffsets;
+    qint64 validEnd = 0;              // 已读入索引的最后一条完整记录的结尾
+
+    // 索引
+    QHash<QString, int> nameIds;
+    QHash<quint64, int> pairCounts;
+    QVector<QVector<qint64>> lastInGroup; // 人员编号 -> 组号(1-10) -> 最近时间
+};
+
+#endif // SEATINGHISTORY_H
@@ -0,0 +1,466 @@
+#include "seatmapwidget.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double SEAT_WIDTH = 80.0;
+const double SEAT_HEIGHT = 40.0;
+const double SEAT_GAP = 6.0;
+const double TABLE_STRIP = 16.0;   // 两侧座位之间的桌面
+const double LABEL_HEIGHT = 24.0;
+const double BLOCK_GAP = 40.0;
+const double MIN_SCALE = 0.02;
+const double MAX_SCALE = 8.0;
+const int ZOOM_SETTLE_MS = 150;
+
+} // namespace
+
+SeatMapWidget::SeatMapWidget(QWidget* parent)
+    : QWidget(parent)
+{
+    setMouseTracking(false);
+    setMinimumSize(200, 150);
+    zoomSettle.setSingleShot(true);
+    zoomSettle.setInterval(ZOOM_SETTLE_MS);
+    connect(&zoomSettle, &QTimer::timeout, this, &SeatMapWidget::invalidateStatic);
+}
+
+void SeatMapWidget::setPeople(const QVector<PersonDisplay>& newPeople)
+{
+    if (newPeople == people) return;
+    people = newPeople;
+    update();
+}
+
+void SeatMapWidget::setGroups(const QStringList& labels, const QVector<QVector<int>>& rows)
+{
+    rebuildLayout(false, labels, rows);
+}
+
+void SeatMapWidget::setExamGrid(const QVector<QVector<int>>& rows)
+{
+    QStringList labels;
+    for (int r = 0; r < rows.size(); r++) {
+        labels << QString("第%1排").arg(r + 1);
+    }
+    rebuildLayout(true, labels, rows);
+}
+
+// 座位结构（模式、标签、各行座位数）不变时只更新座位上的人，不重排也不重建索引
+void SeatMapWidget::rebuildLayout(bool examGrid, const QStringList& labels, const QVector<QVector<int>>& rows)
+{
+    bool sameStructure = examGrid == examLayout && labels.size() == rows.size() && blocks.size() == labels.size();
+    int seatCount = 0;
+    for (int r = 0; r < rows.size(); r++) {
+        seatCount += rows[r].size();
+        if (sameStructure && blocks[r].label != labels[r]) sameStructure = false;
+    }
+    if (sameStructure && seatCount == seats.size()) {
+        int k = 0;
+        for (int r = 0; r < rows.size() && sameStructure; r++) {
+            for (int s = 0; s < rows[r].size(); s++, k++) {
+                if (seats[k].group != r || seats[k].seat != s) {
+                    sameStructure = false;
+                    break;
+                }
+                occupants[k] = rows[r][s];
+            }
+        }
+        if (sameStructure) {
+            update();
+            return;
+        }
+    }
+
+    examLayout = examGrid;
+    seats.clear();
+    occupants.clear();
+    blocks.clear();
+    selectedSeat = -1;
+    pressedSeat = -1;
+    hoverSeat = -1;
+    dragging = false;
+    panning = false;
+
+    if (examGrid) {
+        // 考场：左侧一列排号，右侧座位网格
+        for (int r = 0; r < rows.size(); r++) {
+            double y = r * (SEAT_HEIGHT + SEAT_GAP);
+            blocks.append({ QRectF(-SEAT_WIDTH - SEAT_GAP, y, SEAT_WIDTH, SEAT_HEIGHT), labels[r] });
+            for (int c = 0; c < rows[r].size(); c++) {
+                seats.append({ QRectF(c * (SEAT_WIDTH + SEAT_GAP), y, SEAT_WIDTH, SEAT_HEIGHT), r, c });
+                occupants.append(rows[r][c]);
+            }
+        }
+    }
+    else {
+        // 分组：每组一张桌子，座位分列两侧，桌子按接近正方形的网格排列
+        int blockColumns = qMax(1, int(std::ceil(std::sqrt(double(rows.size())))));
+        int maxPerSide = 1;
+        for (const auto& row : rows) {
+            maxPerSide = qMax(maxPerSide, int(row.size() + 1) / 2);
+        }
+        double blockWidth = maxPerSide * (SEAT_WIDTH + SEAT_GAP) + SEAT_GAP;
+        double blockHeight = LABEL_HEIGHT + 2 * SEAT_HEIGHT + TABLE_STRIP + 2 * SEAT_GAP;
+
+        for (int g = 0; g < rows.size(); g++) {
+            double left = (g % blockColumns) * (blockWidth + BLOCK_GAP);
+            double top = (g / blockColumns) * (blockHeight + BLOCK_GAP);
+            blocks.append({ QRectF(left, top, blockWidth, blockHeight), labels.value(g) });
+
+            int perSide = (rows[g].size() + 1) / 2;
+            for (int s = 0; s < rows[g].size(); s++) {
+                bool upper = s < perSide;
+                int column = upper ? s : s - perSide;
+                double x = left + SEAT_GAP + column * (SEAT_WIDTH + SEAT_GAP);
+                double y = top + LABEL_HEIGHT + (upper ? 0.0 : SEAT_HEIGHT + TABLE_STRIP + SEAT_GAP);
+                seats.append({ QRectF(x, y, SEAT_WIDTH, SEAT_HEIGHT), g, s });
+                occupants.append(rows[g][s]);
+            }
+        }
+    }
+
+    sceneBounds = QRectF();
+    for (const Block& block : blocks) {
+        sceneBounds = sceneBounds.united(block.rect);
+    }
+    for (const Seat& seat : seats) {
+        sceneBounds = sceneBounds.united(seat.rect);
+    }
+
+    rebuildIndex();
+    fitToView();
+}
+
+void SeatMapWidget::rebuildIndex()
+{
+    bucketColumns = qMax(1, int(std::ceil(sceneBounds.width() / BUCKET)) + 1);
+    bucketRows = qMax(1, int(std::ceil(sceneBounds.height() / BUCKET)) + 1);
+    buckets = QVector<QVector<int>>(bucketColumns * bucketRows);
+
+    // 每个座位只登记在其中心所在的格子里，查询时把区域向外扩一个座位的大小
+    for (int i = 0; i < seats.size(); i++) {
+        QPointF center = seats[i].rect.center() - sceneBounds.topLeft();
+        int bx = qBound(0, int(center.x() / BUCKET), bucketColumns - 1);
+        int by = qBound(0, int(center.y() / BUCKET), bucketRows - 1);
+        buckets[by * bucketColumns + bx].append(i);
+    }
+}
+
+QVector<int> SeatMapWidget::seatsIn(const QRectF& sceneRect) const
+{
+    QVector<int> found;
+    if (buckets.isEmpty()) return found;
+
+    QRectF area = sceneRect.adjusted(-SEAT_WIDTH, -SEAT_HEIGHT, SEAT_WIDTH, SEAT_HEIGHT)
+        .translated(-sceneBounds.topLeft());
+    int x0 = qBound(0, int(std::floor(area.left() / BUCKET)), bucketColumns - 1);
+    int x1 = qBound(0, int(std::floor(area.right() / BUCKET)), bucketColumns - 1);
+    int y0 = qBound(0, int(std::floor(area.top() / BUCKET)), bucketRows - 1);
+    int y1 = qBound(0, int(std::floor(area.bottom() / BUCKET)), bucketRows - 1);
+    for (int by = y0; by <= y1; by++) {
+        for (int bx = x0; bx <= x1; bx++) {
+            for (int i : buckets[by * bucketColumns + bx]) {
+                if (seats[i].rect.intersects(sceneRect)) found.append(i);
+            }
+        }
+    }
+    return found;
+}
+
+int SeatMapWidget::seatAt(const QPointF& scenePoint) const
+{
+    for (int i : seatsIn(QRectF(scenePoint, QSizeF(0.01, 0.01)))) {
+        if (seats[i].rect.contains(scenePoint)) return i;
+    }
+    return -1;
+}
+
+QPointF SeatMapWidget::toScene(const QPointF& widgetPoint) const
+{
+    return (widgetPoint - offset) / scale;
+}
+
+QRectF SeatMapWidget::visibleScene() const
+{
+    return QRectF(toScene(QPointF(0, 0)), toScene(QPointF(width(), height())));
+}
+
+void SeatMapWidget::fitToView()
+{
+    if (sceneBounds.isEmpty()) {
+        scale = 1.0;
+        offset = QPointF();
+    }
+    else {
+        double margin = 20.0;
+        scale = qBound(MIN_SCALE, qMin((width() - 2 * margin) / sceneBounds.width(),
+            (height() - 2 * margin) / sceneBounds.height()), MAX_SCALE);
+        offset = QPointF(width() / 2.0, height() / 2.0) - sceneBounds.center() * scale;
+    }
+    invalidateStatic();
+}
+
+void SeatMapWidget::invalidateStatic()
+{
+    staticValid = false;
+    update();
+}
+
+// 静态层：背景、桌子轮廓和组号（排号），与座位上是谁无关
+void SeatMapWidget::paintStatic()
+{
+    qreal ratio = devicePixelRatioF();
+    staticLayer = QPixmap(size() * ratio);
+    staticLayer.setDevicePixelRatio(ratio);
+    staticLayer.fill(palette().color(QPalette::Base));
+
+    QPainter painter(&staticLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(offset);
+    painter.scale(scale, scale);
+    staticOffset = offset;
+    staticScale = scale;
+
+    QRectF visible = visibleScene();
+    QFont font = painter.font();
+    font.setPointSizeF(11.0);
+    painter.setFont(font);
+    for (const Block& block : blocks) {
+        if (!block.rect.intersects(visible)) continue;
+        if (!examLayout) {
+            painter.setPen(QPen(QColor(160, 160, 160), 1.0 / scale));
+            painter.setBrush(QColor(245, 240, 230));
+            painter.drawRoundedRect(block.rect, 6, 6);
+            QRectF labelRect(block.rect.left(), block.rect.top(), block.rect.width(), LABEL_HEIGHT);
+            if (scale * LABEL_HEIGHT >= 8) painter.drawText(labelRect, Qt::AlignCenter, block.label);
+        }
+        else if (scale * SEAT_HEIGHT >= 8) {
+            painter.setPen(palette().color(QPalette::Text));
+            painter.drawText(block.rect, Qt::AlignCenter, block.label);
+        }
+    }
+    staticValid = true;
+}
+
+void SeatMapWidget::paintEvent(QPaintEvent*)
+{
+    if (!staticValid || staticLayer.size() != size() * devicePixelRatioF()) {
+        paintStatic();
+    }
+
+    QPainter painter(this);
+    if (staticOffset == offset && staticScale == scale) {
+        painter.drawPixmap(0, 0, staticLayer);
+    }
+    else {
+        // 平移或缩放还没结束：旧位图换算到当前视图贴上，露出的边缘先填背景
+        painter.fillRect(rect(), palette().color(QPalette::Base));
+        double k = scale / staticScale;
+        painter.save();
+        painter.translate(offset - staticOffset * k);
+        painter.scale(k, k);
+        painter.drawPixmap(0, 0, staticLayer);
+        painter.restore();
+    }
+    painter.translate(offset);
+    painter.scale(scale, scale);
+
+    // 缩得很小时只画色块，不画名字
+    bool drawNames = scale * SEAT_HEIGHT >= 14;
+    QFont font = painter.font();
+    QFont boldFont = font;
+    boldFont.setBold(true);
+    painter.setPen(QPen(QColor(120, 120, 120), 1.0 / scale));
+
+    for (int i : seatsIn(visibleScene())) {
+        const Seat& seat = seats[i];
+        int person = occupants[i];
+        if (person <= 0 || person >= people.size()) {
+            painter.setBrush(Qt::white);
+            painter.drawRect(seat.rect);
+            continue;
+        }
+
+        const PersonDisplay& display = people[person];
+        QColor color = display.boarder ? QColor(Qt::yellow)
+            : display.male ? QColor(200, 230, 255) : QColor(255, 230, 255);
+        painter.setBrush(color);
+        painter.drawRect(seat.rect);
+        if (drawNames) {
+            painter.setFont(display.leader ? boldFont : font);
+            QString text = display.note.isEmpty() ? display.name : QString("%1\n%2").arg(display.name, display.note);
+            painter.drawText(seat.rect, Qt::AlignCenter, text);
+        }
+    }
+
+    if (selectedSeat >= 0) {
+        painter.setBrush(Qt::NoBrush);
+        painter.setPen(QPen(QColor(220, 60, 60), 3.0 / scale));
+        painter.drawRect(seats[selectedSeat].rect);
+    }
+
+    if (dragging) {
+        painter.resetTransform();
+        paintDragOverlay(painter);
+    }
+}
+
+void SeatMapWidget::resizeEvent(QResizeEvent*)
+{
+    invalidateStatic();
+}
+
+void SeatMapWidget::wheelEvent(QWheelEvent* event)
+{
+    QPointF cursor = event->position();
+    QPointF anchor = toScene(cursor);
+    double factor = std::pow(1.0015, event->angleDelta().y());
+    scale = qBound(MIN_SCALE, scale * factor, MAX_SCALE);
+    offset = cursor - anchor * scale;
+    zoomSettle.start();
+    update();
+    event->accept();
+}
+
+void SeatMapWidget::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton) return;
+    panning = true;
+    panned = false;
+    panStart = event->position();
+    offsetAtPanStart = offset;
+
+    // 分组模式下按在有人的座位上开始的拖动是移动这个人，否则是平移
+    pressedSeat = -1;
+    if (!examLayout) {
+        int hit = seatAt(toScene(panStart));
+        if (hit >= 0 && occupants[hit] > 0) pressedSeat = hit;
+    }
+}
+
+void SeatMapWidget::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!panning) return;
+    QPointF delta = event->position() - panStart;
+    if (!panned && delta.manhattanLength() < 4) return;
+
+    if (!panned && pressedSeat >= 0) {
+        dragging = true;
+        dragPerson = occupants[pressedSeat];
+        hoverSeat = -1;
+        feedbackText.clear();
+        selectedSeat = -1;
+        emit dragStarted(dragPerson);
+    }
+    panned = true;
+
+    if (dragging) {
+        dragPos = event->position();
+        int hit = seatAt(toScene(dragPos));
+        if (hit == pressedSeat) hit = -1;
+        if (hit != hoverSeat) {
+            hoverSeat = hit;
+            feedbackText.clear();
+            if (hit >= 0) emit moveHovered(dragPerson, seats[hit].group, seats[hit].seat);
+        }
+        update();
+        return;
+    }
+
+    offset = offsetAtPanStart + delta;
+    update();
+}
+
+// 没有拖动时视为点击：先选中一个人，再点目标座位请求移动；点空白处取消选择
+void SeatMapWidget::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || !panning) return;
+    panning = false;
+
+    if (dragging) {
+        int target = hoverSeat;
+        int person = dragPerson;
+        dragging = false;
+        hoverSeat = -1;
+        feedbackText.clear();
+        update();
+        if (target >= 0) emit moveRequested(person, seats[target].group, seats[target].seat);
+        return;
+    }
+    if (panned) {
+        invalidateStatic();
+        return;
+    }
+
+    int hit = seatAt(toScene(event->position()));
+    if (hit < 0) {
+        selectedSeat = -1;
+        update();
+        return;
+    }
+
+    emit seatClicked(seats[hit].group, seats[hit].seat);
+    if (examLayout) return;
+
+    if (selectedSeat < 0 || selectedSeat == hit) {
+        selectedSeat = (selectedSeat == hit || occupants[hit] <= 0) ? -1 : hit;
+    }
+    else {
+        int person = occupants[selectedSeat];
+        selectedSeat = -1;
+        emit moveRequested(person, seats[hit].group, seats[hit].seat);
+    }
+    update();
+}
+
+void SeatMapWidget::setMoveFeedback(const QString& text, bool allowed)
+{
+    if (!dragging) return;
+    feedbackText = text;
+    feedbackAllowed = allowed;
+    update();
+}
+
+// 拖动中的人跟随光标，目标座位按提示着色，提示文字显示在光标旁
+void SeatMapWidget::paintDragOverlay(QPainter& painter)
+{
+    if (hoverSeat >= 0) {
+        painter.save();
+        painter.translate(offset);
+        painter.scale(scale, scale);
+        painter.setBrush(Qt::NoBrush);
+        QColor color = feedbackText.isEmpty() ? QColor(120, 120, 120)
+            : feedbackAllowed ? QColor(40, 160, 60) : QColor(220, 60, 60);
+        painter.setPen(QPen(color, 3.0 / scale));
+        painter.drawRect(seats[hoverSeat].rect);
+        painter.restore();
+    }
+
+    if (dragPerson > 0 && dragPerson < people.size()) {
+        QRectF ghost(dragPos - QPointF(SEAT_WIDTH, SEAT_HEIGHT) / 2, QSizeF(SEAT_WIDTH, SEAT_HEIGHT));
+        painter.setOpacity(0.7);
+        painter.setPen(QColor(120, 120, 120));
+        painter.setBrush(QColor(230, 230, 230));
+        painter.drawRect(ghost);
+        painter.drawText(ghost, Qt::AlignCenter, people[dragPerson].name);
+        painter.setOpacity(1.0);
+    }
+
+    if (!feedbackText.isEmpty()) {
+        QRectF box = painter.fontMetrics().boundingRect(QRect(0, 0, 320, 0), Qt::TextWordWrap, feedbackText);
+        box.adjust(-6, -4, 6, 4);
+        box.moveTopLeft(dragPos + QPointF(16, SEAT_HEIGHT / 2 + 4));
+        if (box.right() > width()) box.moveRight(width());
+        if (box.bottom() > height()) box.moveBottom(dragPos.y() - SEAT_HEIGHT / 2 - 4);
+        painter.setPen(QColor(120, 120, 120));
+        painter.setBrush(QColor(255, 255, 225));
+        painter.drawRect(box);
+        painter.setPen(palette().color(QPalette::ToolTipText));
+        painter.drawText(box.adjusted(6, 4, -6, -4), Qt::TextWordWrap, feedbackText);
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#ifndef SEATMAPWIDGET_H
+#define SEATMAPWIDGET_H
+
+#include <QPixmap>
+#include <QPointF>
+#include <QRectF>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+#include "grouptablemodel.h"
+
+// 座位图：按几何位置绘制每个座位，颜色规则与分组表格相同（PersonDisplay）
+// 分组模式下每组是一张桌子，座位分列两侧；考场模式按排、列排成网格。
+// 座位坐标放在场景坐标系中，滚轮以光标为中心缩放，在空白处按左键拖动平移。
+// 分组模式下可把人拖到另一个座位：悬停在目标上时发出 moveHovered，调用方用 setMoveFeedback 回填提示
+// 绘制时先用均匀网格空间索引找出视口内的座位，只画可见的部分；
+// 桌子轮廓和组号这一静态层缓存为位图，只在布局或窗口大小变化、平移结束、缩放停止后重画；
+// 平移和连续缩放过程中把旧位图按偏移和比例贴上去
+class SeatMapWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit SeatMapWidget(QWidget* parent = nullptr);
+
+    void setPeople(const QVector<PersonDisplay>& people);
+
+    // 分组模式：rows[i] 为第 i 组的座位，labels 为各组标签
+    void setGroups(const QStringList& labels, const QVector<QVector<int>>& rows);
+    // 考场模式：rows 为各排座位
+    void setExamGrid(const QVector<QVector<int>>& rows);
+
+    // 缩放到显示全部座位
+    void fitToView();
+
+    // 当前悬停目标的移动提示，allowed 决定目标框的颜色
+    void setMoveFeedback(const QString& text, bool allowed);
+
+signals:
+    // 把人拖到目标座位松开，或先点选一个人再点目标座位时发出
+    void moveRequested(int personId, int targetGroup, int targetSeat);
+    // 开始拖动一个人
+    void dragStarted(int personId);
+    // 拖动中悬停的目标座位改变
+    void moveHovered(int personId, int targetGroup, int targetSeat);
+    // 点击座位（group 为组或排的下标）
+    void seatClicked(int group, int seat);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+
+private:
+    struct Seat {
+        QRectF rect;   // 场景坐标
+        int group;
+        int seat;
+    };
+    struct Block {
+        QRectF rect;
+        QString label;
+    };
+
+    void rebuildLayout(bool examGrid, const QStringList& labels, const QVector<QVector<int>>& rows);
+    void rebuildIndex();
+    QVector<int> seatsIn(const QRectF& sceneRect) const;
+    int seatAt(const QPointF& scenePoint) const;
+    QPointF toScene(const QPointF& widgetPoint) const;
+    QRectF visibleScene() const;
+    void invalidateStatic();
+    void paintStatic();
+    void paintDragOverlay(QPainter& painter);
+
+    QVector<PersonDisplay> people;
+    QVector<Seat> seats;
+    QVector<int> occupants;       // 与 seats 对应的人员ID
+    QVector<Block> blocks;
+    QRectF sceneBounds;
+    bool examLayout = false;
+
+    // 空间索引：场景按 BUCKET 边长划分网格，每格记录中心落在格内的座位下标
+    static constexpr double BUCKET = 256.0;
+    int bucketColumns = 0;
+    int bucketRows = 0;
+    QVector<QVector<int>> buckets;
+
+    double scale = 1.0;
+    QPointF offset;               // 场景原点在窗口中的位置
+    bool panning = false;
+    bool panned = false;
+    QPointF panStart;
+    QPointF offsetAtPanStart;
+
+    QPixmap staticLayer;
+    bool staticValid = false;
+    double staticScale = 1.0;     // 静态层绘制时的缩放和偏移
+    QPointF staticOffset;
+    QTimer zoomSettle;            // 滚轮停下一段时间后再重画静态层
+
+    int selectedSeat = -1;        // 已点选的座位（seats 下标）
+
+    // 拖动一个人
+    int pressedSeat = -1;         // 按下时所在的有人座位，-1 表示按在空白处（平移）
+    int dragPerson = 0;
+    bool dragging = false;
+    QPointF dragPos;
+    int hoverSeat = -1;
+    QString feedbackText;
+    bool feedbackAllowed = false;
+};
+
+#endif // SEATMAPWIDGET_H
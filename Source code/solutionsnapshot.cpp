@@ -0,0 +1,21 @@
+#include "solutionsnapshot.h"
+
+bool SolutionSnapshot::offer(const QVector<QVector<int>>& groups, int penalty)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bestPenalty >= 0 && penalty >= bestPenalty) return false;
+    bestGroups = groups;
+    bestPenalty = penalty;
+    version++;
+    return true;
+}
+
+bool SolutionSnapshot::fetch(QVector<QVector<int>>& groups, int& penalty, quint64& knownVersion) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (version == knownVersion) return false;
+    groups = bestGroups;
+    penalty = bestPenalty;
+    knownVersion = version;
+    return true;
+}
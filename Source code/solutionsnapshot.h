@@ -0,0 +1,32 @@
+#pragma once
+
+#ifndef SOLUTIONSNAPSHOT_H
+#define SOLUTIONSNAPSHOT_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <atomic>
+#include <mutex>
+
+// 求解过程中的"当前最好方案"，供后台求解线程发布、界面线程读取
+// 只接受代价更低的方案，每次更新版本号加一；界面按版本号判断是否需要重绘
+class SolutionSnapshot {
+public:
+    // 方案比当前最好的更好时保存并返回 true
+    bool offer(const QVector<QVector<int>>& groups, int penalty);
+
+    // 版本号比 knownVersion 新时取出方案并更新 knownVersion
+    bool fetch(QVector<QVector<int>>& groups, int& penalty, quint64& knownVersion) const;
+
+    void markFinished() { finished.store(true, std::memory_order_release); }
+    bool isFinished() const { return finished.load(std::memory_order_acquire); }
+
+private:
+    mutable std::mutex mutex;
+    QVector<QVector<int>> bestGroups;
+    int bestPenalty = -1;
+    quint64 version = 0;
+    std::atomic<bool> finished{ false };
+};
+
+#endif // SOLUTIONSNAPSHOT_H
@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef SOLVERARENA_H
+#define SOLVERARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+// 一次求解运行的临时内存
+// 单调分配：单个释放是空操作，运行结束时随对象析构一次性归还。
+// 先用构造时申请的初始缓冲区，用完后再向系统申请按倍数增长的大块。
+// 求解器的临时数组都挂在同一个 arena 上并在每轮中 clear() 复用容量，热身之后几乎不再分配
+// （不使用 <memory_resource>：macOS 14 之前的 libc++ 没有提供）
+class SolverArena {
+public:
+    explicit SolverArena(std::size_t initialBytes = 64 * 1024)
+        : nextBlockBytes(initialBytes) {}
+    SolverArena(const SolverArena&) = delete;
+    SolverArena& operator=(const SolverArena&) = delete;
+
+    SolverArena* resource() { return this; }
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        std::size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(cursor) % alignment) % alignment;
+        if (cursor == nullptr || padding + bytes > remaining) {
+            std::size_t blockBytes = std::max(nextBlockBytes, bytes + alignment);
+            blocks.emplace_back(new std::byte[blockBytes]);
+            cursor = blocks.back().get();
+            remaining = blockBytes;
+            nextBlockBytes = blockBytes * 2;
+            padding = (alignment - reinterpret_cast<std::uintptr_t>(cursor) % alignment) % alignment;
+        }
+        std::byte* result = cursor + padding;
+        cursor = result + bytes;
+        remaining -= padding + bytes;
+        return result;
+    }
+
+private:
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::byte* cursor = nullptr;
+    std::size_t remaining = 0;
+    std::size_t nextBlockBytes;
+};
+
+// 从 SolverArena 分配的分配器；默认构造（没有 arena）时使用普通堆内存
+template<class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    ArenaAllocator(SolverArena* arenaPtr) noexcept : arena(arenaPtr) {}
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(std::size_t n)
+    {
+        if (!arena) return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        if (!arena) ::operator delete(p);
+    }
+
+    friend bool operator==(const ArenaAllocator& a, const ArenaAllocator& b) { return a.arena == b.arena; }
+    friend bool operator!=(const ArenaAllocator& a, const ArenaAllocator& b) { return a.arena != b.arena; }
+
+    SolverArena* arena = nullptr;
+};
+
+// 分配在 SolverArena 上的数组
+template<class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // SOLVERARENA_H
@@ -0,0 +1,102 @@
+#include "swapadvisor.h"
+#include "assignmentscore.h"
+#include "taskpool.h"
+#include <algorithm>
+
+namespace {
+
+bool betterSuggestion(const SwapSuggestion& a, const SwapSuggestion& b)
+{
+    if (a.penaltyDelta != b.penaltyDelta) return a.penaltyDelta < b.penaltyDelta;
+    if (a.cycle.size() != b.cycle.size()) return a.cycle.size() < b.cycle.size();
+    return a.cycle < b.cycle;
+}
+
+// 只保留最好的 n 个
+void keepBest(QVector<SwapSuggestion>& suggestions, int n)
+{
+    if (suggestions.size() <= n) return;
+    std::partial_sort(suggestions.begin(), suggestions.begin() + n, suggestions.end(), betterSuggestion);
+    suggestions.resize(n);
+}
+
+} // namespace
+
+SwapAdvisor::SwapAdvisor(std::shared_ptr<const ProblemModel> problem)
+    : model(std::move(problem))
+{
+}
+
+SwapAdvice SwapAdvisor::suggest(const QVector<QVector<int>>& groups, int person)
+{
+    SwapAdvice advice;
+    if (person < 1 || person > model->personCount || model->isFixed(person) || groups.size() != model->groupCount) {
+        return advice;
+    }
+
+    AssignmentScore base;
+    base.build(model, groups);
+    int home = base.groupOf(person);
+    if (home < 0) return advice;
+
+    // 各组中可与选中的人交换的候选
+    QVector<QVector<int>> candidates(model->groupCount);
+    for (int g = 0; g < model->groupCount; g++) {
+        if (g == home) continue;
+        for (int other : groups[g]) {
+            if (other == 0 || model->isFixed(other) || model->isMale(other) != model->isMale(person)) continue;
+            candidates[g].append(other);
+        }
+    }
+
+    // 每个任务写自己的槽位，合并前不需要加锁；任务中只读访问共享数据
+    QVector<QVector<SwapSuggestion>> found(model->groupCount);
+    QVector<int> evaluated(model->groupCount, 0);
+    QVector<SwapSuggestion>* foundSlots = found.data();
+    int* evaluatedSlots = evaluated.data();
+    const QVector<QVector<int>>& candidatesOf = candidates;
+    {
+        TaskPool::TaskGroup tasks;
+        for (int h = 0; h < model->groupCount; h++) {
+            if (candidatesOf[h].isEmpty()) continue;
+            tasks.run([&, h]() {
+                AssignmentScore score = base;
+                QVector<SwapSuggestion>& local = foundSlots[h];
+                int count = 0;
+                for (int b : candidatesOf[h]) {
+                    local.append({ { person, b }, score.swapDelta(person, b) });
+                    count++;
+                    if (!includeCycles) continue;
+
+                    // 三人循环：person → h，b → c 的组，c → home
+                    for (int k = 0; k < model->groupCount; k++) {
+                        if (k == h) continue;
+                        for (int c : candidatesOf[k]) {
+                            int before = score.total();
+                            score.applyMove(person, h);
+                            score.applyMove(b, k);
+                            score.applyMove(c, home);
+                            int delta = score.total() - before;
+                            score.applyMove(c, k);
+                            score.applyMove(b, h);
+                            score.applyMove(person, home);
+                            local.append({ { person, b, c }, delta });
+                            count++;
+                        }
+                        if (local.size() > 4 * topN) keepBest(local, topN);
+                    }
+                }
+                keepBest(local, topN);
+                evaluatedSlots[h] = count;
+                });
+        }
+    }
+
+    for (int h = 0; h < model->groupCount; h++) {
+        advice.suggestions += found[h];
+        advice.evaluated += evaluated[h];
+    }
+    keepBest(advice.suggestions, topN);
+    std::sort(advice.suggestions.begin(), advice.suggestions.end(), betterSuggestion);
+    return advice;
+}
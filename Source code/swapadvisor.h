@@ -0,0 +1,40 @@
+#pragma once
+
+#ifndef SWAPADVISOR_H
+#define SWAPADVISOR_H
+
+#include <QVector>
+#include <memory>
+#include "problemmodel.h"
+
+// 一个推荐的移动：cycle[0] 是选中的人，每人移到下一人所在的组和座位，最后一人移到 cycle[0] 原来的位置。
+// 两人时就是一次交换
+struct SwapSuggestion {
+    QVector<int> cycle;
+    int penaltyDelta = 0;
+};
+
+struct SwapAdvice {
+    QVector<SwapSuggestion> suggestions;   // 按代价变化从小到大，相同时人数少的在前
+    int evaluated = 0;                     // 试算的方案数
+};
+
+// 为选中的人推荐交换对象
+// 候选是其他组中同性别、没有固定位置的人：与之两人交换，或三人循环（选中的人 → b 的组，b → c 的组，
+// c → 选中的人的组，三人分属三个组）。各组男女人数不变。
+// 按 b 所在的组划分任务交给 TaskPool，每个任务用自己的 AssignmentScore 副本试算并保留本地前 N 个，
+// 最后合并
+class SwapAdvisor {
+public:
+    explicit SwapAdvisor(std::shared_ptr<const ProblemModel> model);
+
+    SwapAdvice suggest(const QVector<QVector<int>>& groups, int person);
+
+    int topN = 5;
+    bool includeCycles = true;
+
+private:
+    std::shared_ptr<const ProblemModel> model;
+};
+
+#endif // SWAPADVISOR_H
@@ -0,0 +1,221 @@
+#include "taskpool.h"
+
+namespace {
+
+// 当前线程所属的线程池及其工作线程下标，池外线程为 nullptr / -1
+thread_local TaskPool* currentPool = nullptr;
+thread_local int currentWorker = -1;
+
+} // namespace
+
+// ---------- Chase-Lev 双端队列 ----------
+
+bool TaskPool::WorkDeque::push(Task* task)
+{
+    qint64 b = bottom.load(std::memory_order_relaxed);
+    qint64 t = top.load(std::memory_order_acquire);
+    if (b - t >= CAPACITY) return false;
+    buffer[b & (CAPACITY - 1)].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+TaskPool::Task* TaskPool::WorkDeque::pop()
+{
+    qint64 b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    qint64 t = top.load(std::memory_order_relaxed);
+
+    Task* task = nullptr;
+    if (t <= b) {
+        task = buffer[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            // 只剩最后一个任务，与窃取方竞争
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+    }
+    else {
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+TaskPool::Task* TaskPool::WorkDeque::steal()
+{
+    qint64 t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    qint64 b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+
+    Task* task = buffer[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+// ---------- 线程池 ----------
+
+TaskPool::TaskPool(int threadCount)
+{
+    threadCount = qMax(1, threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        deques.push_back(std::make_unique<WorkDeque>());
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true);
+    }
+    wakeUp.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+TaskPool& TaskPool::instance()
+{
+    static TaskPool pool(qMax(2, int(std::thread::hardware_concurrency())));
+    return pool;
+}
+
+void TaskPool::submit(Task* task)
+{
+    bool queued = false;
+    if (currentPool == this && currentWorker >= 0) {
+        queued = deques[currentWorker]->push(task);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        injectQueue.push_back(task);
+        queued = true;
+    }
+
+    if (!queued) {
+        execute(task);
+        return;
+    }
+    queuedTasks.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_one();
+}
+
+// 取任务的顺序：自己的队列 → 注入队列 → 从其他线程窃取
+TaskPool::Task* TaskPool::findTask()
+{
+    if (queuedTasks.load() == 0) return nullptr;
+
+    if (currentPool == this && currentWorker >= 0) {
+        if (Task* task = deques[currentWorker]->pop()) return task;
+    }
+    {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        if (!injectQueue.empty()) {
+            Task* task = injectQueue.front();
+            injectQueue.pop_front();
+            return task;
+        }
+    }
+    int n = int(deques.size());
+    int start = currentWorker >= 0 ? currentWorker + 1 : 0;
+    for (int k = 0; k < n; k++) {
+        int victim = (start + k) % n;
+        if (victim == currentWorker && currentPool == this) continue;
+        if (Task* task = deques[victim]->steal()) return task;
+    }
+    return nullptr;
+}
+
+void TaskPool::execute(Task* task)
+{
+    TaskGroup* group = task->group;
+    if (!group->token.isCancelled()) {
+        task->function();
+    }
+    delete task;
+
+    // 在锁内递减并通知：等待方返回前要先取得这把锁，组对象不会在通知途中被销毁
+    bool last = false;
+    {
+        std::lock_guard<std::mutex> lock(group->doneMutex);
+        last = group->pending.fetch_sub(1, std::memory_order_release) == 1;
+        if (last) {
+            group->done.notify_all();
+        }
+    }
+
+    // 等待中的工作线程休眠在 wakeUp 上，组完成时也要叫醒它们（此后不再访问组对象）
+    if (last) {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wakeUp.notify_all();
+    }
+}
+
+bool TaskPool::runOneTask()
+{
+    Task* task = findTask();
+    if (!task) return false;
+    queuedTasks.fetch_sub(1);
+    execute(task);
+    return true;
+}
+
+void TaskPool::workerLoop(int index)
+{
+    currentPool = this;
+    currentWorker = index;
+    while (!stopping.load()) {
+        if (runOneTask()) continue;
+
+        // 没有任务时休眠到有新任务或线程池停止；submit 在 sleepMutex 内计数后通知，不会错过
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() {
+            return stopping.load() || queuedTasks.load() > 0;
+            });
+    }
+}
+
+// ---------- 任务组 ----------
+
+void TaskPool::TaskGroup::run(std::function<void()> function)
+{
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.submit(new Task{ std::move(function), this });
+}
+
+void TaskPool::TaskGroup::wait()
+{
+    auto finished = [this]() { return pending.load(std::memory_order_acquire) == 0; };
+    std::unique_lock<std::mutex> lock(doneMutex, std::defer_lock);
+
+    if (currentPool == &pool && currentWorker >= 0) {
+        // 嵌套并行：本线程本来就是池中的一个核，协助执行任务；
+        // 没有任务可做时与空闲线程一样休眠，有新任务提交或本组完成时被叫醒
+        while (!finished()) {
+            if (pool.runOneTask()) continue;
+            std::unique_lock<std::mutex> sleepLock(pool.sleepMutex);
+            pool.wakeUp.wait(sleepLock, [&]() {
+                return finished() || pool.queuedTasks.load() > 0;
+                });
+        }
+    }
+
+    // 池外线程不执行任务，避免在工作线程之外多占一个核，也不会接手其他求解的长任务
+    lock.lock();
+    done.wait(lock, finished);
+}
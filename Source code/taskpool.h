@@ -0,0 +1,93 @@
+#pragma once
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "canceltoken.h"
+
+// 求解任务专用的工作窃取线程池
+// 每个工作线程有自己的双端队列（Chase-Lev 算法）：本线程在底部无锁压入/弹出，
+// 其他线程从顶部用一次 CAS 窃取。池外线程提交的任务进入一个加锁的注入队列。
+// 线程数按硬件并发数确定；在任务中再开并行任务并等待时，等待的工作线程会顺便执行队列中的任务，
+// 嵌套并行不会额外创建线程。池外线程（如界面线程）等待时只休眠，不占用额外的核
+class TaskPool {
+public:
+    explicit TaskPool(int threadCount);
+    ~TaskPool();
+
+    // 全局实例，线程数为硬件并发数
+    static TaskPool& instance();
+
+    int threadCount() const { return int(workers.size()); }
+
+    // 一组相关任务：共享一个取消标记，可以等待全部完成
+    class TaskGroup {
+    public:
+        explicit TaskGroup(TaskPool& pool = TaskPool::instance()) : pool(pool) {}
+        ~TaskGroup() { wait(); }
+
+        void run(std::function<void()> function);
+
+        // 等待本组任务全部完成。工作线程等待期间协助执行池中的任务，池外线程在条件变量上休眠
+        void wait();
+
+        void cancel() { token.cancel(); }
+        const CancelToken& cancelToken() const { return token; }
+
+    private:
+        friend class TaskPool;
+        TaskPool& pool;
+        CancelToken token;
+        std::atomic<int> pending{ 0 };
+        std::mutex doneMutex;
+        std::condition_variable done;   // pending 降为 0 时通知
+    };
+
+private:
+    struct Task {
+        std::function<void()> function;
+        TaskGroup* group;
+    };
+
+    // Chase-Lev 双端队列，容量固定，满时由提交方直接执行任务
+    class WorkDeque {
+    public:
+        bool push(Task* task);
+        Task* pop();
+        Task* steal();
+
+    private:
+        static const qint64 CAPACITY = 1024;
+        std::atomic<qint64> top{ 0 };
+        std::atomic<qint64> bottom{ 0 };
+        std::atomic<Task*> buffer[CAPACITY] = {};
+    };
+
+    void submit(Task* task);
+    bool runOneTask();
+    Task* findTask();
+    void execute(Task* task);
+    void workerLoop(int index);
+
+    std::vector<std::unique_ptr<WorkDeque>> deques;
+    std::vector<std::thread> workers;
+
+    std::mutex injectMutex;
+    std::deque<Task*> injectQueue;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<int> queuedTasks{ 0 };
+    std::atomic<bool> stopping{ false };
+};
+
+#endif // TASKPOOL_H